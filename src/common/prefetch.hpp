@@ -0,0 +1,15 @@
+#pragma once
+
+#if defined(_MSC_VER)
+    #include <intrin.h>
+#endif
+
+
+inline void prefetch(const void* ptr) noexcept
+{
+#if defined(_MSC_VER)
+    _mm_prefetch(static_cast<const char*>(ptr), _MM_HINT_T0);
+#else
+    __builtin_prefetch(ptr);
+#endif
+}
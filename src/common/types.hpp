@@ -1,6 +1,29 @@
 #pragma once
 
 #include <inttypes.h>
+#include <memory>
 
+#if defined(UMI_SLIM_COMPONENTS)
+    #include <boost/intrusive_ptr.hpp>
+#endif
 
+
+// Defining UMI_SLIM_COMPONENTS narrows ids to 32 bits and replaces the shared_ptr to the entity's
+// components_map by an intrusive pointer, shrinking every component header from 32 to 20 bytes
+#if defined(UMI_SLIM_COMPONENTS)
+using entity_id_t = uint32_t;
+#else
 using entity_id_t = uint64_t;
+#endif
+
+
+class components_map;
+
+#if defined(UMI_SLIM_COMPONENTS)
+inline void intrusive_ptr_add_ref(components_map* x);
+inline void intrusive_ptr_release(components_map* x);
+
+using components_map_ptr = boost::intrusive_ptr<components_map>;
+#else
+using components_map_ptr = std::shared_ptr<components_map>;
+#endif
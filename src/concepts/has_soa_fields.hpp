@@ -0,0 +1,21 @@
+#pragma once
+
+#include <tuple>
+#include <type_traits>
+
+// Components opt into struct-of-arrays storages by listing their hot fields, ie.
+//  using soa_fields = std::tuple<glm::vec3, glm::vec3>;
+template <typename D>
+concept has_soa_fields = requires
+    {
+        { std::tuple_size<typename D::soa_fields>::value };
+    };
+
+template <typename D>
+struct has_soa_fields_scope
+{
+    inline static constexpr bool value = has_soa_fields<D>;
+};
+
+template <typename D>
+inline constexpr bool has_soa_fields_v = has_soa_fields_scope<D>::value;
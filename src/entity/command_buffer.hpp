@@ -0,0 +1,268 @@
+#pragma once
+
+#include "entity/scheme.hpp"
+#include "storage/storage.hpp"
+
+#include <pool/fiber_pool.hpp>
+
+#include <tao/tuple/tuple.hpp>
+
+#include <algorithm>
+#include <atomic>
+#include <functional>
+#include <iterator>
+#include <tuple>
+#include <utility>
+#include <vector>
+
+
+// Records structural changes to a scheme, so that they can be issued from fibers while its orchestrators
+//  are being iterated. Commands are kept per worker, thus recording needs no synchronization, and must be
+//  recorded from inside the fiber pool. They are played back at a sync point, where each kind of command
+//  is sorted by entity id and issued in a single batch, so the outcome does not depend on scheduling.
+// Entities are referred to by id, those that do not exist at playback are skipped. Commands still recorded
+//  when a buffer is destroyed are never played back, not even by a later buffer
+template <typename... comps>
+class command_buffer
+{
+    using scheme_t = scheme<comps...>;
+    using first_t = std::tuple_element_t<0, std::tuple<comps...>>;
+    using creator_t = std::function<void(scheme_t&, uint64_t)>;
+
+    struct commands
+    {
+        std::vector<std::pair<uint64_t, creator_t>> creates;
+        std::vector<std::pair<uint64_t, uint8_t>> partitions;
+        std::vector<std::pair<scheme_t*, uint64_t>> moves;
+        std::vector<uint64_t> destroys;
+    };
+
+    // Every buffer of the same scheme type shares the per worker storage. Buffers are looked up by an id, which
+    //  is never reused, thus entries left by destroyed buffers are harmless
+    using local_commands = std::vector<std::pair<uint64_t, commands>>;
+
+public:
+    command_buffer(scheme_t& scheme) noexcept;
+
+    command_buffer(command_buffer&& other) noexcept = delete;
+    command_buffer& operator=(command_buffer&& rhs) noexcept = delete;
+
+    // Arguments are the same as `scheme::create`, and are copied until playback
+    template <typename... A>
+    void create(uint64_t id, A&&... scheme_args) noexcept
+        requires (... && !std::is_lvalue_reference<A>::value);
+
+    void destroy(uint64_t id) noexcept;
+    // If an entity is moved more than once, the last move recorded by the highest worker wins
+    void move(scheme_t& to, uint64_t id) noexcept;
+
+    // `p` is a boolean for partitioned storages, or the partition number for multi-partitioned ones. If an
+    //  entity is changed more than once, the last change recorded by the highest worker wins
+    template <typename P>
+    void change_partition(P p, uint64_t id) noexcept;
+
+    // Must be called from inside the fiber pool, when no view is iterating the scheme nor any fiber is recording.
+    //  Creations are issued first, then partition changes, moves and finally destructions
+    void playback() noexcept;
+
+private:
+    commands& local() noexcept;
+    commands gather() noexcept;
+
+    void playback_partitions(std::vector<std::pair<uint64_t, uint8_t>>& partitions) noexcept;
+    void playback_moves(std::vector<std::pair<scheme_t*, uint64_t>>& moves) noexcept;
+    void playback_destroys(std::vector<uint64_t>& destroys) noexcept;
+
+private:
+    static inline std::atomic<uint64_t> _next_id = 0;
+
+    uint64_t _id;
+    scheme_t& _scheme;
+};
+
+
+template <typename... comps>
+command_buffer<comps...>::command_buffer(scheme_t& scheme) noexcept :
+    _id(_next_id.fetch_add(1, std::memory_order_relaxed)),
+    _scheme(scheme)
+{}
+
+template <typename... comps>
+template <typename... A>
+void command_buffer<comps...>::create(uint64_t id, A&&... scheme_args) noexcept
+    requires (... && !std::is_lvalue_reference<A>::value)
+{
+    local().creates.emplace_back(id, [args = tao::tuple<std::decay_t<A>...>(std::move(scheme_args)...)](scheme_t& scheme, uint64_t id) mutable {
+        tao::apply([&scheme, id](auto&... args) {
+            scheme.create(id, std::move(args)...);
+        }, args);
+    });
+}
+
+template <typename... comps>
+void command_buffer<comps...>::destroy(uint64_t id) noexcept
+{
+    local().destroys.push_back(id);
+}
+
+template <typename... comps>
+void command_buffer<comps...>::move(scheme_t& to, uint64_t id) noexcept
+{
+    local().moves.emplace_back(&to, id);
+}
+
+template <typename... comps>
+template <typename P>
+void command_buffer<comps...>::change_partition(P p, uint64_t id) noexcept
+{
+    static_assert(is_partitioned_storage(first_t::tag) || is_multi_partitioned_storage(first_t::tag), "Scheme storages must be partitioned");
+    local().partitions.emplace_back(id, static_cast<uint8_t>(p));
+}
+
+template <typename... comps>
+typename command_buffer<comps...>::commands& command_buffer<comps...>::local() noexcept
+{
+    auto& buffers = np::this_fiber::template threadlocal<local_commands>();
+    for (auto& [id, commands] : buffers)
+    {
+        if (id == _id)
+        {
+            return commands;
+        }
+    }
+
+    return buffers.emplace_back(_id, commands()).second;
+}
+
+template <typename... comps>
+typename command_buffer<comps...>::commands command_buffer<comps...>::gather() noexcept
+{
+    commands all;
+
+    auto fiber_pool = np::this_fiber::fiber_pool();
+    auto& per_thread_commands = fiber_pool->template threadlocal_all<local_commands>();
+    for (uint8_t i = 0, size = fiber_pool->maximum_worker_id(); i < size; ++i)
+    {
+        auto& buffers = per_thread_commands[i];
+        auto it = std::find_if(buffers.begin(), buffers.end(), [this](auto& buffer) { return buffer.first == _id; });
+        if (it == buffers.end())
+        {
+            continue;
+        }
+
+        // Local buffers are cleared but kept, so that their capacity is reused
+        auto& local = it->second;
+        std::move(local.creates.begin(), local.creates.end(), std::back_inserter(all.creates));
+        all.partitions.insert(all.partitions.end(), local.partitions.begin(), local.partitions.end());
+        all.moves.insert(all.moves.end(), local.moves.begin(), local.moves.end());
+        all.destroys.insert(all.destroys.end(), local.destroys.begin(), local.destroys.end());
+
+        local.creates.clear();
+        local.partitions.clear();
+        local.moves.clear();
+        local.destroys.clear();
+    }
+
+    return all;
+}
+
+template <typename... comps>
+void command_buffer<comps...>::playback() noexcept
+{
+    auto all = gather();
+
+    std::stable_sort(all.creates.begin(), all.creates.end(), [](auto& a, auto& b) { return a.first < b.first; });
+    for (auto& [id, creator] : all.creates)
+    {
+        creator(_scheme, id);
+    }
+
+    if constexpr (is_partitioned_storage(first_t::tag) || is_multi_partitioned_storage(first_t::tag))
+    {
+        playback_partitions(all.partitions);
+    }
+
+    playback_moves(all.moves);
+    playback_destroys(all.destroys);
+}
+
+template <typename... comps>
+void command_buffer<comps...>::playback_partitions(std::vector<std::pair<uint64_t, uint8_t>>& partitions) noexcept
+{
+    // Only the last change of each entity is kept
+    std::stable_sort(partitions.begin(), partitions.end(), [](auto& a, auto& b) { return a.first < b.first; });
+    auto last = std::unique(partitions.rbegin(), partitions.rend(), [](auto& a, auto& b) { return a.first == b.first; });
+    partitions.erase(partitions.begin(), last.base());
+
+    if constexpr (is_partitioned_storage(first_t::tag))
+    {
+        std::vector<typename scheme_t::entity_tuple_t> to_true;
+        std::vector<typename scheme_t::entity_tuple_t> to_false;
+        for (auto [id, p] : partitions)
+        {
+            if (auto entity = _scheme.find(id))
+            {
+                (p ? to_true : to_false).push_back(*entity);
+            }
+        }
+
+        _scheme.change_partition_n(true, to_true);
+        _scheme.change_partition_n(false, to_false);
+    }
+    else
+    {
+        auto& first = _scheme.template get<first_t>();
+        for (auto [id, p] : partitions)
+        {
+            if (auto entity = _scheme.find(id); entity && first.raw_storage().partition(tao::get<0>(entity->downcast())) != p)
+            {
+                _scheme.change_partition(p, tao::get<0>(entity->downcast()));
+            }
+        }
+    }
+}
+
+template <typename... comps>
+void command_buffer<comps...>::playback_moves(std::vector<std::pair<scheme_t*, uint64_t>>& moves) noexcept
+{
+    // Only the last move of each entity is kept, then grouped by destination so that each group is moved at once
+    std::stable_sort(moves.begin(), moves.end(), [](auto& a, auto& b) { return a.second < b.second; });
+    auto last = std::unique(moves.rbegin(), moves.rend(), [](auto& a, auto& b) { return a.second == b.second; });
+    moves.erase(moves.begin(), last.base());
+    std::stable_sort(moves.begin(), moves.end(), [](auto& a, auto& b) { return std::less<scheme_t*>()(a.first, b.first); });
+
+    std::vector<typename scheme_t::entity_tuple_t> entities;
+    for (auto it = moves.begin(); it != moves.end();)
+    {
+        auto to = it->first;
+        for (; it != moves.end() && it->first == to; ++it)
+        {
+            if (auto entity = _scheme.find(it->second))
+            {
+                entities.push_back(*entity);
+            }
+        }
+
+        _scheme.move_n(*to, entities);
+        entities.clear();
+    }
+}
+
+template <typename... comps>
+void command_buffer<comps...>::playback_destroys(std::vector<uint64_t>& destroys) noexcept
+{
+    std::sort(destroys.begin(), destroys.end());
+    destroys.erase(std::unique(destroys.begin(), destroys.end()), destroys.end());
+
+    std::vector<typename scheme_t::entity_tuple_t> entities;
+    entities.reserve(destroys.size());
+    for (auto id : destroys)
+    {
+        if (auto entity = _scheme.find(id))
+        {
+            entities.push_back(*entity);
+        }
+    }
+
+    _scheme.destroy_n(entities);
+}
@@ -24,8 +24,11 @@ class component : public pool_item<component<T>>
 
     // Friends with all storage types
     template <pool_item_derived D, uint32_t N> friend class growable_storage;
+    template <pool_item_derived D, uint32_t N, uint8_t K> friend class multi_partitioned_growable_storage;
+    template <pool_item_derived D, uint32_t N> friend class paged_growable_storage;
     template <pool_item_derived D, uint32_t N> friend class partitioned_growable_storage;
     template <pool_item_derived D, uint32_t N> friend class partitioned_static_storage;
+    template <pool_item_derived D, uint32_t N> friend class soa_storage;
     template <pool_item_derived D, uint32_t N> friend class static_growable_storage;
     template <pool_item_derived D, uint32_t N> friend class static_storage;
 
@@ -34,12 +37,28 @@ public:
 
     // Define noexcept defaults
     component() noexcept = default;
-    component(component&&) noexcept = default;
-    component& operator=(component&&) noexcept = default;
+
+    // Moving keeps the entity components map pointing at this component, as it does with the ticket
+    component(component&& other) noexcept :
+        pool_item<component<T>>(std::move(other)),
+        _components(std::move(other._components)),
+        _id(other._id)
+    {
+        refresh_components();
+    }
+
+    component& operator=(component&& other) noexcept
+    {
+        pool_item<component<T>>::operator=(std::move(other));
+        _components = std::move(other._components);
+        _id = other._id;
+        refresh_components();
+        return *this;
+    }
 
     component(entity_id_t id) :
-        _id(id),
-        _components()
+        _components(),
+        _id(id)
     {}
 
 public:
@@ -48,7 +67,7 @@ public:
         return _id;
     }
 
-    inline std::shared_ptr<components_map>& components() noexcept
+    inline components_map_ptr& components() noexcept
     {
         return _components;
     }
@@ -59,6 +78,13 @@ public:
         return _components->template get<D>();
     }
 
+    // Direct lookup, `index` must come from the entity's `scheme::component_index<D>()`
+    template <typename D>
+    inline D* get(uint32_t index) const noexcept
+    {
+        return _components->template get<D>(index);
+    }
+
     template <typename D>
     inline void push_component(component<D>* component) noexcept
     {
@@ -76,6 +102,14 @@ public:
     }
 
 private:
+    inline void refresh_components() noexcept
+    {
+        if (_components)
+        {
+            _components->template refresh<T>(this);
+        }
+    }
+
     template <typename... Args>
     constexpr inline void base_construct(entity_id_t id, Args&&... args) noexcept;
 
@@ -85,14 +119,15 @@ private:
     template <typename... Args>
     constexpr inline void base_destroy(Args&&... args) noexcept;
 
-    constexpr inline void base_scheme_created(const std::shared_ptr<components_map>& map) noexcept;
+    constexpr inline void base_scheme_created(const components_map_ptr& map) noexcept;
 
     template <template <typename...> typename S, typename... comps>
     constexpr inline void base_scheme_information(S<comps...>& scheme) noexcept;
 
 protected:
+    // Pointers first, so that a 32 bits id leaves its tail padding to the derived component
+    components_map_ptr _components;
     entity_id_t _id;
-    std::shared_ptr<components_map> _components;
 };
 
 
@@ -105,6 +140,11 @@ constexpr inline void component<derived_t>::base_construct(entity_id_t id, Args&
     static_assert(std::is_nothrow_constructible_v<derived_t>, "Components must be nothrow constructible");
     static_assert(std::is_nothrow_move_constructible_v<derived_t>, "Components must be nothrow move constructible");
 
+#if defined(UMI_SLIM_COMPONENTS)
+    // A ticket, the components map pointer and a 32 bits id
+    static_assert(sizeof(component<derived_t>) <= 24, "Slim component headers must not exceed 24 bytes");
+#endif
+
     _id = id;
 
 #if (__DEBUG__ || FORCE_ALL_CONSTRUCTORS) && !DISABLE_DEBUG_CONSTRUCTOR
@@ -139,7 +179,7 @@ constexpr inline void component<derived_t>::base_destroy(Args&&... args) noexcep
 }
 
 template <typename derived_t>
-constexpr inline void component<derived_t>::base_scheme_created(const std::shared_ptr<components_map>& map) noexcept
+constexpr inline void component<derived_t>::base_scheme_created(const components_map_ptr& map) noexcept
 {
     _components = map;
 
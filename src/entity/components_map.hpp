@@ -4,66 +4,229 @@
 
 #include "storage/ticket.hpp"
 #include "common/tao.hpp"
+#include "common/types.hpp"
 #include "entity/component.hpp"
 #include "traits/contains.hpp"
 
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <cassert>
 #include <inttypes.h>
-#include <unordered_map>
+#include <memory>
 
 template <typename D> class component;
 
 
-// TODO(gpascualg): Use something along the lines of https://github.com/serge-sans-paille/frozen but with dynamic construction size?
-
+// Type-erased record shared by all components of an entity. Components are stored in a flat array,
+// in scheme order, sized once at creation, so that lookups are a short scan (or a direct load when the
+// index is known, see `scheme::component_index`) and creating an entity allocates only once. Each slot
+// holds the component address, refreshed by the component whenever it moves, as tickets are. Components
+// pushed beyond the scheme ones spill the array to the heap
 class components_map
 {
+#if defined(UMI_SLIM_COMPONENTS)
+    friend void intrusive_ptr_add_ref(components_map* x);
+    friend void intrusive_ptr_release(components_map* x);
+#endif
+
+protected:
+    struct slot
+    {
+        uint32_t hash;
+        void* ptr;
+        // Only kept to hold a reference, lookups never go through it
+        void* ticket;
+        void (*release)(void*) noexcept;
+    };
+
 public:
     template <typename T> using bare_t = typename std::remove_pointer_t<std::decay_t<T>>;
 
-    components_map() = default;
-    components_map(components_map&& other) noexcept = default;
-    components_map& operator=(components_map&& other) noexcept = default;
+    virtual ~components_map() noexcept;
+
+    components_map(const components_map& other) = delete;
+    components_map& operator=(const components_map& other) = delete;
+
+    template <typename T>
+    inline T* get() const noexcept;
+
+    template <typename T>
+    inline T* get(uint32_t index) const noexcept;
+
+    template <typename T>
+    inline void push(component<T>* component) noexcept;
+
+    // Called by components when they move
+    template <typename T>
+    inline void refresh(component<T>* component) noexcept;
 
+    inline uint32_t size() const noexcept;
+
+protected:
+    components_map(slot* slots, uint32_t capacity) noexcept;
+
+    template <typename... Comps>
+    inline void emplace_components(Comps... comps) noexcept;
+
+    template <typename T>
+    inline void emplace(const typename ::ticket<component<T>>::ptr& ticket) noexcept;
+
+private:
+    void grow() noexcept;
+
+private:
+    slot* _slots;
+    uint32_t _size;
+    uint32_t _capacity;
+    std::unique_ptr<slot[]> _spilled;
+#if defined(UMI_SLIM_COMPONENTS)
+    std::atomic<uint32_t> _refs = 0;
+#endif
+};
+
+template <uint32_t N>
+class sized_components_map final : public components_map
+{
+public:
     template <typename... Ts>
-    components_map(const tao::tuple<Ts...>& components)
+    sized_components_map(const tao::tuple<Ts...>& components) noexcept;
+
+private:
+    std::array<slot, N> _storage;
+};
+
+
+inline components_map::components_map(slot* slots, uint32_t capacity) noexcept :
+    _slots(slots),
+    _size(0),
+    _capacity(capacity),
+    _spilled(nullptr)
+{}
+
+inline components_map::~components_map() noexcept
+{
+    for (uint32_t i = 0; i < _size; ++i)
     {
-        // MSVC has a hard time doing everything with std::apply inside here
-        emplace_components(tao::get<Ts>(components)...);
+        _slots[i].release(_slots[i].ticket);
     }
+}
 
-    template <typename... Comps>
-    inline void emplace_components(Comps&&... comps) noexcept
+template <typename T>
+inline T* components_map::get() const noexcept
+{
+    constexpr uint32_t hash = type_hash<bare_t<T>>();
+    for (uint32_t i = 0; i < _size; ++i)
     {
-        (..., _components.emplace(
-            type_hash<bare_t<decltype(comps)>>(),
-                [ticket = comps->ticket()]() {
-                return reinterpret_cast<void*>(ticket->get());
-            })
-        );
+        if (_slots[i].hash == hash)
+        {
+            return static_cast<T*>(_slots[i].ptr);
+        }
     }
 
-    template <typename T>
-    inline T* get() const
+    return nullptr;
+}
+
+template <typename T>
+inline T* components_map::get(uint32_t index) const noexcept
+{
+    assert(index < _size && _slots[index].hash == type_hash<bare_t<T>>() && "Component index does not match its type");
+    return static_cast<T*>(_slots[index].ptr);
+}
+
+template <typename T>
+inline void components_map::push(component<T>* component) noexcept
+{
+    emplace<T>(component->ticket());
+}
+
+template <typename T>
+inline void components_map::refresh(component<T>* component) noexcept
+{
+    constexpr uint32_t hash = type_hash<bare_t<T>>();
+    for (uint32_t i = 0; i < _size; ++i)
     {
-        if (auto it = _components.find(type_hash<bare_t<T>>()); it != _components.end())
+        if (_slots[i].hash == hash)
         {
-            return reinterpret_cast<T*>(it->second());
+            _slots[i].ptr = component->derived();
+            return;
         }
-
-        return nullptr;
     }
+}
 
-    template <typename T>
-    inline void push(component<T>* component)
+inline uint32_t components_map::size() const noexcept
+{
+    return _size;
+}
+
+template <typename... Comps>
+inline void components_map::emplace_components(Comps... comps) noexcept
+{
+    (..., emplace<typename bare_t<Comps>::derived_t>(comps->ticket()));
+}
+
+template <typename T>
+inline void components_map::emplace(const typename ::ticket<component<T>>::ptr& ticket) noexcept
+{
+    if (_size == _capacity)
     {
-        _components.emplace(type_hash<bare_t<T>>(), [ticket = component->ticket()]() {
-            return ticket->get()->derived();
-        });
+        grow();
     }
 
-protected:
-    explicit components_map(const components_map& other) = default;
+    // Hold a reference, as the std::function capturing the ticket used to do
+    intrusive_ptr_add_ref(ticket.get());
+    _slots[_size++] = {
+        .hash = type_hash<bare_t<T>>(),
+        .ptr = ticket->get(),
+        .ticket = ticket.get(),
+        .release = [](void* ptr) noexcept {
+            intrusive_ptr_release(static_cast<::ticket<component<T>>*>(ptr));
+        }
+    };
+}
 
-private:
-    std::unordered_map<uint32_t, std::function<void*()>> _components;
-};
+inline void components_map::grow() noexcept
+{
+    const uint32_t capacity = std::max<uint32_t>(_capacity * 2, 4);
+    auto spilled = std::make_unique<slot[]>(capacity);
+    std::copy(_slots, _slots + _size, spilled.get());
+
+    _spilled = std::move(spilled);
+    _slots = _spilled.get();
+    _capacity = capacity;
+}
+
+template <uint32_t N>
+template <typename... Ts>
+sized_components_map<N>::sized_components_map(const tao::tuple<Ts...>& components) noexcept :
+    components_map(_storage.data(), N),
+    _storage()
+{
+    // MSVC has a hard time doing everything with std::apply inside here
+    emplace_components(tao::get<Ts>(components)...);
+}
+
+template <typename... Ts>
+inline components_map_ptr make_components_map(const tao::tuple<Ts...>& components)
+{
+#if defined(UMI_SLIM_COMPONENTS)
+    return components_map_ptr(new sized_components_map<sizeof...(Ts)>(components));
+#else
+    return std::make_shared<sized_components_map<sizeof...(Ts)>>(components);
+#endif
+}
+
+#if defined(UMI_SLIM_COMPONENTS)
+inline void intrusive_ptr_add_ref(components_map* x)
+{
+    ++x->_refs;
+}
+
+inline void intrusive_ptr_release(components_map* x)
+{
+    if (--x->_refs == 0)
+    {
+        delete x;
+    }
+}
+#endif
@@ -0,0 +1,112 @@
+#pragma once
+
+#include "entity/scheme.hpp"
+#include "storage/storage.hpp"
+
+#include <range/v3/view/take.hpp>
+#include <range/v3/view/zip.hpp>
+
+#include <tao/tuple/tuple.hpp>
+
+#include <vector>
+
+
+// Owns the orchestrators of a scheme and keeps every entity that has all of its components at the
+// same position in all of them, within a prefix of `size()` elements. Iterating the group is thus a
+// plain zip of dense arrays, whatever the storages are and whichever other schemes share them.
+// Entities pushed after the last `refresh` are not part of the group yet, group views refresh it
+template <typename... comps>
+class owning_group
+{
+    static_assert((!is_partitioned_storage(comps::tag) && ...), "Partitioned storages can't be owned by a group");
+    static_assert((!is_multi_partitioned_storage(comps::tag) && ...), "Partitioned storages can't be owned by a group");
+
+public:
+    template <typename T>
+    using orchestrator_t = orchestrator_type<T, comps...>;
+
+    owning_group(const scheme<comps...>& scheme) noexcept;
+    ~owning_group() noexcept;
+
+    // Orchestrators point back to the group, thus it can't be moved
+    owning_group(owning_group&& other) noexcept = delete;
+    owning_group& operator=(owning_group&& rhs) noexcept = delete;
+
+    template <typename T>
+    constexpr inline std::add_lvalue_reference_t<orchestrator_t<T>> get() const noexcept
+    {
+        return *tao::get<std::add_pointer_t<orchestrator_t<T>>>(_components);
+    }
+
+    // Swaps every entity that has been completed since the last call into the owned prefix
+    void refresh() noexcept;
+
+    inline auto range() noexcept
+    {
+        return ranges::views::zip(ranges::views::take(get<comps>().range(), size())...);
+    }
+
+    inline uint32_t size() const noexcept;
+
+private:
+    tao::tuple<std::add_pointer_t<comps>...> _components;
+    std::vector<uint64_t> _joins;
+};
+
+
+template <typename... comps>
+owning_group<comps...>::owning_group(const scheme<comps...>& scheme) noexcept :
+    _components(&scheme.template get<comps>()...),
+    _joins()
+{
+    tao::apply([this](auto first, auto... others) {
+        assert(!first->_is_grouped && (!others->_is_grouped && ...) && "Orchestrator is already owned by a group");
+
+        // Only the first member reports pushes, an entity can't be complete without it
+        first->_group_joins = &_joins;
+        first->_is_grouped = true;
+        ((others->_is_grouped = true), ...);
+
+        // Entities created before the group join it on the first refresh
+        for (auto obj : first->raw_storage().range())
+        {
+            _joins.push_back(obj->id());
+        }
+    }, _components);
+}
+
+template <typename... comps>
+owning_group<comps...>::~owning_group() noexcept
+{
+    tao::apply([](auto... orchestrators) {
+        ((orchestrators->_is_grouped = false), ...);
+        ((orchestrators->_group_size = 0), ...);
+        ((orchestrators->_group_joins = nullptr), ...);
+    }, _components);
+}
+
+template <typename... comps>
+void owning_group<comps...>::refresh() noexcept
+{
+    assert(((get<comps>()._group_size == size()) && ...) && "Group members have been modified separately");
+
+    for (uint64_t id : _joins)
+    {
+        // Ids might be stale, or belong to entities without some of the components
+        auto objects = tao::tuple(get<comps>().get(id)...);
+        tao::apply([this](auto... objects) {
+            if ((objects && ...))
+            {
+                (get<comps>().group_join(objects), ...);
+            }
+        }, objects);
+    }
+
+    _joins.clear();
+}
+
+template <typename... comps>
+inline uint32_t owning_group<comps...>::size() const noexcept
+{
+    return tao::get<0>(_components)->_group_size;
+}
@@ -8,12 +8,17 @@
 #include "traits/tuple.hpp"
 #include "traits/without_duplicates.hpp"
 
-#include <range/v3/algorithm/partition.hpp>
 #include <range/v3/view/zip.hpp>
 
 #include <tao/tuple/tuple.hpp>
 #include <spdlog/spdlog.h>
 
+#include <algorithm>
+#include <limits>
+#include <optional>
+#include <span>
+#include <vector>
+
 
 template <typename... comps>
 struct scheme;
@@ -32,6 +37,7 @@ namespace detail
         component comp;
         tao::tuple<Args...> args;
         bool predicate;
+        uint8_t partition;
     };
 }
 
@@ -120,6 +126,14 @@ struct entity_tuple : public tao::tuple<comps...>
         return static_cast<tao::tuple<comps...>&>(*this);
     }
 
+    // Entities searched by id might lack components, ie. when a storage is shared with other schemes
+    inline bool complete() const noexcept
+    {
+        return tao::apply([](auto... args) {
+            return (... && (args != nullptr));
+        }, downcast());
+    }
+
     inline constexpr uint64_t id() const noexcept
     {
         return tao::get<0>(downcast())->id();
@@ -195,19 +209,48 @@ public:
         return entity_tuple_t(get<comps>().get(id)...);
     }
 
+    // As `search`, but only finds entities holding every component of the scheme. Storages may be shared
+    //  among schemes, and then `search` also finds the components of other schemes' entities
+    constexpr inline auto find(uint64_t id) const noexcept -> std::optional<entity_tuple_t>
+    {
+        if (auto entity = search(id); entity.complete())
+        {
+            return entity;
+        }
+
+        return std::nullopt;
+    }
+
+    // Start the index loads of `search(id)` ahead of it, see `view_detail::for_each_batched`
+    constexpr inline void prefetch(uint64_t id) const noexcept
+    {
+        (get<comps>().prefetch(id), ...);
+    }
+
+    constexpr inline void prefetch_entry(uint64_t id) const noexcept
+    {
+        (get<comps>().prefetch_entry(id), ...);
+    }
+
     template <typename T>
     constexpr inline bool has() const noexcept
     {
         return has_type<T, tao::tuple<comps...>>::value;
     }
 
+    template <typename T>
+    static constexpr inline uint32_t component_index() noexcept
+    {
+        return static_cast<uint32_t>(index_of<T, tao::tuple<typename comps::derived_t...>>::value);
+    }
+
     template <typename T>
     constexpr inline void require() const noexcept
     {
         static_assert(has_type<T, tao::tuple<comps...>>::value, "Requirement not met");
     }
 
-    template <typename T, typename... Args, typename = std::enable_if_t<!is_partitioned_storage(orchestrator_t<T>::tag)>>
+    template <typename T, typename... Args, typename = std::enable_if_t<!is_partitioned_storage(orchestrator_t<T>::tag) && !is_multi_partitioned_storage(orchestrator_t<T>::tag)>>
     constexpr auto args(Args&&... args) noexcept -> detail::scheme_arguments<orchestrator_t<T>, std::add_pointer_t<orchestrator_t<T>>, std::decay_t<Args>...>
     {
         using D = orchestrator_t<T>;
@@ -232,6 +275,19 @@ public:
         };
     }
 
+    template <typename T, typename... Args, typename = std::enable_if_t<is_multi_partitioned_storage(orchestrator_t<T>::tag)>>
+    constexpr auto args(uint8_t partition, Args&&... args) noexcept -> detail::scheme_arguments<orchestrator_t<T>, std::add_pointer_t<orchestrator_t<T>>, std::decay_t<Args>...>
+    {
+        using D = orchestrator_t<T>;
+        require<D>();
+
+        return detail::scheme_arguments<orchestrator_t<T>, std::add_pointer_t<D>, std::decay_t<Args>...> {
+            .comp = tao::get<std::add_pointer_t<D>>(components),
+            .args = tao::tuple<std::decay_t<Args>...>(std::forward<Args>(args)...),
+            .partition = partition
+        };
+    }
+
     template <typename T, typename... Args>
     T* alloc(uint64_t id, detail::scheme_arguments<orchestrator_t<T>, std::add_pointer_t<orchestrator_t<T>>, Args...>&& args)
     {
@@ -248,7 +304,7 @@ public:
         auto entities = make_entity_tuple(create_impl(id, std::move(scheme_args)) ...);
 
         // Create dynamic content
-        auto map = std::make_shared<components_map>(entities.downcast());
+        auto map = make_components_map(entities.downcast());
 
         // Notify of complete scheme creation
         tao::apply([&map](auto&&... entities) mutable {
@@ -258,6 +314,34 @@ public:
         return entities;
     }
 
+    // Creates one entity per id, all of them with the same arguments. Each storage grows, and each
+    //  index reserves, only once, and every component is created and notified type by type
+    template <typename... A>
+    auto create_n(std::span<const uint64_t> ids, A&&... scheme_args) noexcept -> std::vector<entity_tuple_t>
+        requires (... && !std::is_lvalue_reference<A>::value)
+    {
+        static_assert(sizeof...(comps) == sizeof...(scheme_args), "Incomplete scheme allocation");
+
+        auto created = tao::tuple(create_n_impl(ids, std::move(scheme_args))...);
+
+        std::vector<entity_tuple_t> entities;
+        entities.reserve(ids.size());
+        for (std::size_t idx = 0; idx < ids.size(); ++idx)
+        {
+            entities.emplace_back(tao::get<std::vector<typename comps::derived_t*>>(created)[idx]...);
+        }
+
+        for (auto& entity : entities)
+        {
+            auto map = make_components_map(entity.downcast());
+            tao::apply([&map](auto&&... entities) mutable {
+                (..., entities->base()->base_scheme_created(map));
+            }, entity.downcast());
+        }
+
+        return entities;
+    }
+
     template <typename T>
     constexpr void destroy(T* object)
     {
@@ -285,6 +369,19 @@ public:
         }, entity.downcast());
     }
 
+    void destroy_n(std::span<entity_tuple_t> entities) noexcept
+    {
+        // Every entity_destroy must see the whole entity, thus it is done before any pop
+        for (auto& entity : entities)
+        {
+            tao::apply([](auto... args) {
+                (..., args->base_entity_destroy(args...));
+            }, entity.downcast());
+        }
+
+        (..., destroy_n_impl<comps>(entities));
+    }
+
     template <typename T>
     constexpr auto move(scheme<comps...>& to, T* object) noexcept
     {
@@ -313,6 +410,25 @@ public:
         }, entity.downcast());
     }
 
+    // Moves all entities at once, updating them in place to their new components. Each source storage
+    //  is compacted in a single pass, and each destination index reserves only once
+    void move_n(scheme<comps...>& to, std::span<entity_tuple_t> entities) noexcept
+    {
+        (..., move_n_impl<comps>(to, entities));
+    }
+
+    // Entities lacking any of the scheme components are skipped
+    template <typename P>
+    auto move_if(scheme<comps...>& to, P&& predicate) noexcept -> std::vector<entity_tuple_t>
+    {
+        std::vector<entity_tuple_t> entities = select([&predicate](entity_tuple_t& entity) {
+            return static_cast<bool>(tao::apply(predicate, entity.downcast()));
+        });
+
+        move_n(to, entities);
+        return entities;
+    }
+
     constexpr inline std::size_t size() const
     {
         return tao::get<0>(components)->size();
@@ -330,17 +446,56 @@ public:
         return tao::get<0>(components)->size_from_partition();
     }
 
-    //template <typename Sorter, typename UnaryPredicate>
-    //void partition(UnaryPredicate&& p)
-    //{
-    //    ranges::partition(ranges::views::zip(get<comps>().range_as_ref()...),
-    //        [p = std::forward<UnaryPredicate>(p)](const auto&... elems) {
-    //            return p(std::get<Sorter>(std::forward_as_tuple(elems...)));
-    //        });
-    //}
+    template <typename T = std::tuple_element_t<0, std::tuple<comps...>>, typename = std::enable_if_t<is_multi_partitioned_storage(orchestrator_t<T>::tag)>>
+    constexpr inline std::size_t size(uint8_t partition) const
+    {
+        return tao::get<0>(components)->size(partition);
+    }
 
-    template <typename T>
-    auto change_partition(bool p, T* object)
+    // Moves every entity to partition `p`, updating them in place. Each orchestrator is reordered once, and
+    //  entities already in `p` are left as they are
+    void change_partition_n(bool p, std::span<entity_tuple_t> entities) noexcept
+    {
+        static_assert((is_partitioned_storage(comps::tag) && ...), "All storages must be partitioned");
+
+        std::vector<std::size_t> positions;
+        std::vector<entity_tuple_t> changing;
+        for (std::size_t idx = 0; idx < entities.size(); ++idx)
+        {
+            if (partition_of(entities[idx]) != p)
+            {
+                positions.push_back(idx);
+                changing.push_back(entities[idx]);
+            }
+        }
+
+        (..., change_partition_n_impl<comps>(changing));
+
+        for (std::size_t idx = 0; idx < positions.size(); ++idx)
+        {
+            entities[positions[idx]] = changing[idx];
+        }
+    }
+
+    // Evaluates `predicate` over the components of every entity, and moves those whose result does not match
+    //  their partition in a single reordering of each orchestrator. Returns the entities that have changed.
+    //  Entities lacking any of the scheme components are skipped
+    template <typename P>
+    auto partition(P&& predicate) noexcept -> std::vector<entity_tuple_t>
+    {
+        static_assert((is_partitioned_storage(comps::tag) && ...), "All storages must be partitioned");
+
+        std::vector<entity_tuple_t> entities = select([this, &predicate](entity_tuple_t& entity) {
+            return static_cast<bool>(tao::apply(predicate, entity.downcast())) != partition_of(entity);
+        });
+
+        (..., change_partition_n_impl<comps>(entities));
+        return entities;
+    }
+
+    // `p` is a boolean for partitioned storages, or the partition number for multi-partitioned ones
+    template <typename P, typename T>
+    auto change_partition(P p, T* object)
     {
         if constexpr (sizeof...(comps) == 1)
         {
@@ -364,12 +519,18 @@ private:
     template <typename T>
     auto create_impl(uint64_t id, T&& scheme_args) noexcept
     {
+        assert(id <= std::numeric_limits<entity_id_t>::max() && "Entity id does not fit in entity_id_t");
+
         // Create by invoking with arguments
         auto entity = tao::apply([&scheme_args, &id](auto&&... args) {
             if constexpr (is_partitioned_storage(T::orchestrator_t::tag))
             {
                 return scheme_args.comp->push(scheme_args.predicate, id, std::forward<std::decay_t<decltype(args)>>(args)...);
             }
+            else if constexpr (is_multi_partitioned_storage(T::orchestrator_t::tag))
+            {
+                return scheme_args.comp->push(scheme_args.partition, id, std::forward<std::decay_t<decltype(args)>>(args)...);
+            }
             else
             {
                 return scheme_args.comp->push(id, std::forward<std::decay_t<decltype(args)>>(args)...);
@@ -382,6 +543,106 @@ private:
         return entity;
     }
 
+    template <typename T>
+    auto create_n_impl(std::span<const uint64_t> ids, T&& scheme_args) noexcept
+    {
+        assert(std::all_of(ids.begin(), ids.end(), [](uint64_t id) { return id <= std::numeric_limits<entity_id_t>::max(); })
+            && "Entity id does not fit in entity_id_t");
+
+        std::vector<typename T::orchestrator_t::derived_t*> entities(ids.size());
+        tao::apply([&scheme_args, &ids, &entities](const auto&... args) {
+            if constexpr (is_partitioned_storage(T::orchestrator_t::tag))
+            {
+                scheme_args.comp->push_n(entities, scheme_args.predicate, ids, args...);
+            }
+            else if constexpr (is_multi_partitioned_storage(T::orchestrator_t::tag))
+            {
+                scheme_args.comp->push_n(entities, scheme_args.partition, ids, args...);
+            }
+            else
+            {
+                scheme_args.comp->push_n(entities, ids, args...);
+            }
+        }, scheme_args.args);
+
+        for (auto entity : entities)
+        {
+            entity->base()->base_scheme_information(*this);
+        }
+
+        return entities;
+    }
+
+    template <typename O>
+    static inline auto gather(std::span<entity_tuple_t> entities) noexcept
+    {
+        std::vector<typename O::derived_t*> objects;
+        objects.reserve(entities.size());
+        for (auto& entity : entities)
+        {
+            objects.push_back(entity.template get<typename O::derived_t>());
+        }
+
+        return objects;
+    }
+
+    template <typename O>
+    inline void destroy_n_impl(std::span<entity_tuple_t> entities) noexcept
+    {
+        auto objects = gather<O>(entities);
+        get<O>().pop_n(objects);
+    }
+
+    // Complete entities for which `filter` holds, iterating the first orchestrator
+    template <typename F>
+    auto select(F&& filter) noexcept -> std::vector<entity_tuple_t>
+    {
+        std::vector<entity_tuple_t> entities;
+        auto& first = *tao::get<0>(components);
+        for (auto obj : first.range())
+        {
+            if (auto entity = find(obj->id()); entity && filter(*entity))
+            {
+                entities.push_back(*entity);
+            }
+        }
+
+#if !defined(NDEBUG)
+        first.unlock_writes();
+#endif
+        return entities;
+    }
+
+    inline bool partition_of(entity_tuple_t& entity) noexcept
+    {
+        return tao::get<0>(components)->raw_storage().partition(tao::get<0>(entity.downcast()));
+    }
+
+    template <typename O>
+    inline void change_partition_n_impl(std::span<entity_tuple_t> entities) noexcept
+    {
+        auto objects = gather<O>(entities);
+        get<O>().change_partition_n(objects);
+
+        for (std::size_t idx = 0; idx < entities.size(); ++idx)
+        {
+            tao::get<typename O::derived_t*>(entities[idx].downcast()) = objects[idx];
+        }
+    }
+
+    template <typename O>
+    inline void move_n_impl(scheme<comps...>& to, std::span<entity_tuple_t> entities) noexcept
+    {
+        auto objects = gather<O>(entities);
+        get<O>().move_n(to.template get<O>(), objects);
+
+        for (std::size_t idx = 0; idx < entities.size(); ++idx)
+        {
+            objects[idx]->base()->base_scheme_information(*this);
+            tao::get<typename O::derived_t*>(entities[idx].downcast()) = objects[idx];
+        }
+    }
+
     template <typename T, typename tuple, std::size_t... I>
     constexpr inline void destroy_proxy(T* object, std::index_sequence<I...>)
     {
@@ -395,8 +656,8 @@ private:
         return move_impl(to, std::get<typename comps::derived_t*>(temp_tuple)...);
     }
 
-    template <typename T, typename tuple, std::size_t... I>
-    constexpr inline auto change_partition_proxy(bool p, T* object, std::index_sequence<I...>)
+    template <typename T, typename tuple, typename P, std::size_t... I>
+    constexpr inline auto change_partition_proxy(P p, T* object, std::index_sequence<I...>)
     {
         auto temp_tuple = std::tuple_cat(std::make_tuple(object), std::make_tuple(object->template get<std::tuple_element_t<I, tuple>>()...));
         return change_partition_impl(p, std::get<typename comps::derived_t*>(temp_tuple)...);
@@ -424,8 +685,8 @@ private:
         }, tao::tuple(get<comps>().move(to.get<comps>(), entities)...));
     }
 
-    template <typename... Ts>
-    inline auto change_partition_impl(bool p, Ts... objects)
+    template <typename P, typename... Ts>
+    inline auto change_partition_impl(P p, Ts... objects)
     {
         static_assert(sizeof...(Ts) == sizeof...(comps), "Must provide the whole entity components");
         
@@ -0,0 +1,43 @@
+#pragma once
+
+#include <cstddef>
+#include <new>
+
+
+// Minimal allocator handing out storage aligned to (at least) a cache line, so that containers
+// of plain fields can be loaded with aligned vector instructions
+template <typename T, std::size_t Align = 64>
+struct aligned_allocator
+{
+    static constexpr inline std::size_t alignment = Align < alignof(T) ? alignof(T) : Align;
+
+    using value_type = T;
+
+    template <typename U>
+    struct rebind
+    {
+        using other = aligned_allocator<U, Align>;
+    };
+
+    constexpr aligned_allocator() noexcept = default;
+
+    template <typename U>
+    constexpr aligned_allocator(const aligned_allocator<U, Align>&) noexcept
+    {}
+
+    inline T* allocate(std::size_t n)
+    {
+        return static_cast<T*>(::operator new(n * sizeof(T), std::align_val_t(alignment)));
+    }
+
+    inline void deallocate(T* ptr, std::size_t) noexcept
+    {
+        ::operator delete(ptr, std::align_val_t(alignment));
+    }
+
+    template <typename U>
+    constexpr inline bool operator==(const aligned_allocator<U, Align>&) const noexcept
+    {
+        return true;
+    }
+};
@@ -4,14 +4,17 @@
 
 #include <range/v3/view/transform.hpp>
 
+#include <algorithm>
 #include <array>
+#include <functional>
+#include <span>
 #include <vector>
 
 
 template <pool_item_derived T, uint32_t N>
 class growable_storage
 {
-    template <template <typename, uint32_t> typename storage, typename D, uint32_t M>
+    template <template <typename, uint32_t> typename storage, typename D, uint32_t M, template <typename> typename I>
     friend class orchestrator;
 
 public:
@@ -31,8 +34,15 @@ public:
     T* push(Args&&... args) noexcept;
     T* push_ptr(T* obj) noexcept;
 
+    template <typename... Args>
+    void push_n(std::span<T*> out, std::span<const uint64_t> ids, const Args&... args) noexcept;
+
     template <typename... Args>
     void pop(T* obj, Args&&... args) noexcept;
+    void pop_n(std::span<T*> objs) noexcept;
+
+    // Makes room for `count` more elements at once
+    void reserve(uint32_t count) noexcept;
 
     void clear() noexcept;
     
@@ -43,6 +53,14 @@ public:
             [](T& obj) { return &obj; });
     }
 
+    inline auto spans() noexcept
+    {
+        return std::array<std::span<T>, 1> { std::span<T>(_data) };
+    }
+
+    inline uint32_t index(T* obj) const noexcept;
+    inline T* at(uint32_t idx) noexcept;
+
     inline uint32_t size() const noexcept;
     inline bool empty() const noexcept;
     inline bool full() const noexcept;
@@ -85,6 +103,26 @@ T* growable_storage<T, N>::push_ptr(T* obj) noexcept
     return obj;
 }
 
+template <pool_item_derived T, uint32_t N>
+template <typename... Args>
+void growable_storage<T, N>::push_n(std::span<T*> out, std::span<const uint64_t> ids, const Args&... args) noexcept
+{
+    assert(out.size() == ids.size() && "Output and ids sizes do not match");
+
+    const auto first = _data.size();
+    _data.resize(first + ids.size());
+    for (std::size_t idx = 0; idx < ids.size(); ++idx)
+    {
+        out[idx] = &_data[first + idx];
+    }
+
+    base_t::recreate_tickets(out);
+    for (std::size_t idx = 0; idx < ids.size(); ++idx)
+    {
+        static_cast<base_t&>(*out[idx]).base_construct(ids[idx], args...);
+    }
+}
+
 template <pool_item_derived T, uint32_t N>
 template <typename... Args>
 void growable_storage<T, N>::pop(T* obj, Args&&... args) noexcept
@@ -95,6 +133,17 @@ void growable_storage<T, N>::pop(T* obj, Args&&... args) noexcept
     release(obj);
 }
 
+template <pool_item_derived T, uint32_t N>
+void growable_storage<T, N>::pop_n(std::span<T*> objs) noexcept
+{
+    // From the highest index down, releasing an element never moves another one still to be popped
+    std::sort(objs.begin(), objs.end(), std::greater<T*>());
+    for (T* obj : objs)
+    {
+        pop(obj);
+    }
+}
+
 template <pool_item_derived T, uint32_t N>
 void growable_storage<T, N>::release(T* obj) noexcept
 {
@@ -110,6 +159,16 @@ void growable_storage<T, N>::release(T* obj) noexcept
     assert((_data.size() == 0 || _data.back().has_ticket()) && "Operation would leave the vector in an invalid state");
 }
 
+template <pool_item_derived T, uint32_t N>
+void growable_storage<T, N>::reserve(uint32_t count) noexcept
+{
+    // Only ever grow, and geometrically, so that repeated small batches do not reallocate each time
+    if (auto needed = _data.size() + count; needed > _data.capacity())
+    {
+        _data.reserve(std::max(needed, _data.capacity() * 2));
+    }
+}
+
 template <pool_item_derived T, uint32_t N>
 void growable_storage<T, N>::clear() noexcept
 {
@@ -127,6 +186,18 @@ void growable_storage<T, N>::clear() noexcept
     _data.clear();
 }
 
+template <pool_item_derived T, uint32_t N>
+inline uint32_t growable_storage<T, N>::index(T* obj) const noexcept
+{
+    return static_cast<uint32_t>(obj - _data.data());
+}
+
+template <pool_item_derived T, uint32_t N>
+inline T* growable_storage<T, N>::at(uint32_t idx) noexcept
+{
+    return &_data[idx];
+}
+
 template <pool_item_derived T, uint32_t N>
 inline uint32_t growable_storage<T, N>::size() const noexcept
 {
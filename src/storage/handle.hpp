@@ -0,0 +1,101 @@
+#pragma once
+
+#include "storage/slot_table.hpp"
+#include "storage/ticket.hpp"
+
+#include <inttypes.h>
+#include <limits>
+
+
+template <typename T>
+class component;
+
+
+// Non-owning, 64 bits reference to a pooled item. Copying it does not touch any refcount, and
+// resolving it is a single lookup into the type's slot table plus a generation check
+template <typename T>
+class handle
+{
+public:
+    constexpr handle() noexcept;
+    constexpr handle(uint32_t slot, uint32_t generation) noexcept;
+
+    inline bool valid() const noexcept;
+
+    // Empty and stale handles resolve to nullptr, never to the slot's next owner
+    inline auto get() const noexcept;
+
+    // Mimics ticket<T>::ptr, so that handles can be used wherever tickets are (ie. task_manager::schedule_if)
+    inline const handle* operator->() const noexcept
+    {
+        return this;
+    }
+
+    constexpr inline uint64_t value() const noexcept;
+    static constexpr inline handle from_value(uint64_t value) noexcept;
+
+    constexpr inline bool operator==(const handle& other) const noexcept = default;
+
+private:
+    uint32_t _slot;
+    uint32_t _generation;
+};
+
+template <typename T>
+using handle_of_t = ::handle<component<T>>;
+
+
+template <typename T>
+constexpr handle<T>::handle() noexcept :
+    _slot(std::numeric_limits<uint32_t>::max()),
+    _generation(0)
+{}
+
+template <typename T>
+constexpr handle<T>::handle(uint32_t slot, uint32_t generation) noexcept :
+    _slot(slot),
+    _generation(generation)
+{}
+
+template <typename T>
+inline bool handle<T>::valid() const noexcept
+{
+    auto& table = slot_table<T>::instance();
+    if (_slot >= table.capacity())
+    {
+        return false;
+    }
+
+    auto ticket = table.at(_slot);
+    return ticket->_generation.load(std::memory_order_relaxed) == _generation && ticket->_ptr != nullptr;
+}
+
+template <typename T>
+inline auto handle<T>::get() const noexcept
+{
+    auto& table = slot_table<T>::instance();
+    if (_slot >= table.capacity())
+    {
+        return decltype(table.at(_slot)->get())(nullptr);
+    }
+
+    auto ticket = table.at(_slot);
+    if (ticket->_generation.load(std::memory_order_relaxed) != _generation || ticket->_ptr == nullptr)
+    {
+        return decltype(ticket->get())(nullptr);
+    }
+
+    return ticket->get();
+}
+
+template <typename T>
+constexpr inline uint64_t handle<T>::value() const noexcept
+{
+    return (static_cast<uint64_t>(_generation) << 32) | _slot;
+}
+
+template <typename T>
+constexpr inline handle<T> handle<T>::from_value(uint64_t value) noexcept
+{
+    return handle<T>(static_cast<uint32_t>(value), static_cast<uint32_t>(value >> 32));
+}
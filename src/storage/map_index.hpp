@@ -0,0 +1,104 @@
+#pragma once
+
+#include "storage/ticket.hpp"
+
+#include <algorithm>
+#include <inttypes.h>
+#include <unordered_map>
+
+
+template <typename T>
+class component;
+
+
+template <typename T>
+class map_index
+{
+public:
+    using ticket_t = typename ::ticket<component<typename T::derived_t>>::ptr;
+
+    map_index(uint32_t capacity) noexcept;
+
+    map_index(map_index&& other) noexcept = default;
+    map_index& operator=(map_index&& other) noexcept = default;
+
+    inline T* get(uint64_t id) const noexcept;
+    inline void insert(T* obj) noexcept;
+    inline void erase(uint64_t id) noexcept;
+    inline void clear() noexcept;
+
+    // Makes room for `count` more ids at once
+    inline void reserve(uint32_t count) noexcept;
+
+    inline uint32_t size() const noexcept;
+
+    // Nodes can only be reached by walking their bucket, thus there is nothing to start ahead of a lookup
+    inline void prefetch(uint64_t id) const noexcept;
+    inline void prefetch_entry(uint64_t id) const noexcept;
+
+private:
+    std::unordered_map<uint64_t, ticket_t> _tickets;
+};
+
+
+template <typename T>
+map_index<T>::map_index(uint32_t capacity) noexcept :
+    _tickets()
+{
+    _tickets.reserve(capacity);
+}
+
+template <typename T>
+inline T* map_index<T>::get(uint64_t id) const noexcept
+{
+    if (auto it = _tickets.find(id); it != _tickets.end())
+    {
+        // TODO(gpascualg): Why would a ticket inside here be invalid?
+        assert(it->second->valid() && "Orchestrator has an invalid ticket");
+        return it->second->get()->derived();
+    }
+
+    return nullptr;
+}
+
+template <typename T>
+inline void map_index<T>::insert(T* obj) noexcept
+{
+    _tickets.emplace(obj->id(), obj->ticket());
+}
+
+template <typename T>
+inline void map_index<T>::erase(uint64_t id) noexcept
+{
+    _tickets.erase(id);
+}
+
+template <typename T>
+inline void map_index<T>::clear() noexcept
+{
+    _tickets.clear();
+}
+
+template <typename T>
+inline void map_index<T>::reserve(uint32_t count) noexcept
+{
+    // Only ever grow, and geometrically, so that repeated small batches do not rehash each time
+    if (auto needed = _tickets.size() + count; needed > _tickets.bucket_count() * _tickets.max_load_factor())
+    {
+        _tickets.reserve(std::max(needed, _tickets.size() * 2));
+    }
+}
+
+template <typename T>
+inline uint32_t map_index<T>::size() const noexcept
+{
+    return static_cast<uint32_t>(_tickets.size());
+}
+
+template <typename T>
+inline void map_index<T>::prefetch(uint64_t id) const noexcept
+{}
+
+template <typename T>
+inline void map_index<T>::prefetch_entry(uint64_t id) const noexcept
+{}
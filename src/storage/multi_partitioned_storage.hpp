@@ -0,0 +1,351 @@
+#pragma once
+
+#include "storage/storage.hpp"
+
+#include <range/v3/view/slice.hpp>
+#include <range/v3/view/transform.hpp>
+
+#include <algorithm>
+#include <array>
+#include <functional>
+#include <span>
+#include <vector>
+
+
+template <pool_item_derived T, uint32_t N, uint8_t K>
+class multi_partitioned_growable_storage;
+
+// Orchestrators take storages with two template parameters, thus the amount of partitions is bound here:
+//  `orchestrator<multi_partitioned<4>::growable_storage, T, N>`
+template <uint8_t K>
+struct multi_partitioned
+{
+    template <typename T, uint32_t N>
+    using growable_storage = multi_partitioned_growable_storage<T, N, K>;
+};
+
+
+// Elements are kept sorted by partition, each one a contiguous bucket right after the previous one.
+//  Changing an element from one partition to another swaps it across every boundary in between, thus it
+//  takes at most K - 1 swaps and never moves the rest of the elements
+template <pool_item_derived T, uint32_t N, uint8_t K>
+class multi_partitioned_growable_storage
+{
+    static_assert(K >= 2, "Use a continuous storage for a single partition");
+
+    template <template <typename, uint32_t> typename storage, typename D, uint32_t M, template <typename> typename I>
+    friend class orchestrator;
+
+public:
+    static constexpr inline uint8_t tag = storage_tag(storage_grow::growable, storage_layout::multi_partitioned);
+    static constexpr inline uint8_t partitions = K;
+
+    using base_t = component<T>;
+    using derived_t = T;
+    using orchestrator_t = orchestrator<multi_partitioned<K>::template growable_storage, T, N>;
+
+    multi_partitioned_growable_storage() noexcept;
+    ~multi_partitioned_growable_storage() noexcept;
+
+    multi_partitioned_growable_storage(multi_partitioned_growable_storage&& other) noexcept = default;
+    multi_partitioned_growable_storage& operator=(multi_partitioned_growable_storage&& other) noexcept = default;
+
+    template <typename... Args>
+    T* push(uint8_t partition, Args&&... args) noexcept;
+    T* push_ptr(uint8_t partition, T* object) noexcept;
+
+    template <typename... Args>
+    void push_n(std::span<T*> out, uint8_t partition, std::span<const uint64_t> ids, const Args&... args) noexcept;
+
+    template <typename... Args>
+    void pop(T* obj, Args&&... args) noexcept;
+    void pop_n(std::span<T*> objs) noexcept;
+
+    // Makes room for `count` more elements at once
+    void reserve(uint32_t count) noexcept;
+
+    T* change_partition(uint8_t partition, T* obj) noexcept;
+
+    void clear() noexcept;
+
+    inline auto range() noexcept
+    {
+        return ranges::views::transform(
+            _data,
+            [](T& obj) { return &obj; });
+    }
+
+    inline auto range(uint8_t partition) noexcept
+    {
+        return ranges::views::transform(
+            ranges::views::slice(_data, static_cast<std::size_t>(begin(partition)), static_cast<std::size_t>(_ends[partition])),
+            [](T& obj) { return &obj; });
+    }
+
+    inline auto spans() noexcept
+    {
+        return std::array<std::span<T>, 1> { std::span<T>(_data) };
+    }
+
+    inline auto spans(uint8_t partition) noexcept
+    {
+        return std::array<std::span<T>, 1> { std::span<T>(_data.data() + begin(partition), size(partition)) };
+    }
+
+    inline uint32_t index(T* obj) const noexcept;
+    inline uint32_t size() const noexcept;
+    inline uint32_t size(uint8_t partition) const noexcept;
+    inline bool empty() const noexcept;
+    inline bool full() const noexcept;
+
+    inline uint8_t partition(T* obj) const noexcept;
+
+private:
+    void release(T* obj) noexcept;
+    T* insert(uint8_t partition) noexcept;
+
+    inline uint32_t begin(uint8_t partition) const noexcept;
+
+private:
+    std::vector<T> _data;
+
+    // One past the last element of each partition, the last one is always the size
+    std::array<uint32_t, K> _ends;
+};
+
+
+template <pool_item_derived T, uint32_t N, uint8_t K>
+multi_partitioned_growable_storage<T, N, K>::multi_partitioned_growable_storage() noexcept :
+    _data(),
+    _ends()
+{
+    _data.reserve(N);
+}
+
+template <pool_item_derived T, uint32_t N, uint8_t K>
+multi_partitioned_growable_storage<T, N, K>::~multi_partitioned_growable_storage() noexcept
+{
+    clear();
+}
+
+template <pool_item_derived T, uint32_t N, uint8_t K>
+T* multi_partitioned_growable_storage<T, N, K>::insert(uint8_t partition) noexcept
+{
+    assert(partition < K && "Partition out of bounds");
+
+    // Open a hole at the end and carry it down, moving the first element of each partition to its end
+    uint32_t hole = static_cast<uint32_t>(_data.size());
+    _data.emplace_back();
+
+    for (uint8_t current = K - 1; current > partition; --current)
+    {
+        if (auto first = begin(current); first != hole)
+        {
+            _data[hole] = std::move(_data[first]);
+            hole = first;
+        }
+
+        ++_ends[current];
+    }
+
+    ++_ends[partition];
+    return &_data[hole];
+}
+
+template <pool_item_derived T, uint32_t N, uint8_t K>
+template <typename... Args>
+T* multi_partitioned_growable_storage<T, N, K>::push(uint8_t partition, Args&&... args) noexcept
+{
+    T* obj = insert(partition);
+    static_cast<base_t&>(*obj).recreate_ticket();
+    static_cast<base_t&>(*obj).base_construct(std::forward<Args>(args)...);
+    return obj;
+}
+
+template <pool_item_derived T, uint32_t N, uint8_t K>
+T* multi_partitioned_growable_storage<T, N, K>::push_ptr(uint8_t partition, T* object) noexcept
+{
+    T* obj = insert(partition);
+    *obj = std::move(*object);
+    return obj;
+}
+
+template <pool_item_derived T, uint32_t N, uint8_t K>
+template <typename... Args>
+void multi_partitioned_growable_storage<T, N, K>::push_n(std::span<T*> out, uint8_t partition, std::span<const uint64_t> ids, const Args&... args) noexcept
+{
+    assert(out.size() == ids.size() && "Output and ids sizes do not match");
+    assert(partition < K && "Partition out of bounds");
+
+    const auto count = static_cast<uint32_t>(ids.size());
+    _data.resize(_data.size() + count);
+
+    // Shift every later partition `count` positions up, moving as few elements as possible
+    for (uint8_t current = K - 1; current > partition; --current)
+    {
+        const auto moved = std::min(count, size(current));
+        T* from = _data.data() + begin(current);
+        std::move(from, from + moved, _data.data() + _ends[current] + count - moved);
+        _ends[current] += count;
+    }
+
+    T* first = _data.data() + _ends[partition];
+    _ends[partition] += count;
+
+    for (std::size_t idx = 0; idx < count; ++idx)
+    {
+        out[idx] = first + idx;
+    }
+
+    base_t::recreate_tickets(out);
+    for (std::size_t idx = 0; idx < count; ++idx)
+    {
+        static_cast<base_t&>(*out[idx]).base_construct(ids[idx], args...);
+    }
+}
+
+template <pool_item_derived T, uint32_t N, uint8_t K>
+template <typename... Args>
+void multi_partitioned_growable_storage<T, N, K>::pop(T* obj, Args&&... args) noexcept
+{
+    static_cast<base_t&>(*obj).base_destroy(std::forward<Args>(args)...);
+    static_cast<base_t&>(*obj).invalidate_ticket();
+    release(obj);
+}
+
+template <pool_item_derived T, uint32_t N, uint8_t K>
+void multi_partitioned_growable_storage<T, N, K>::pop_n(std::span<T*> objs) noexcept
+{
+    // From the highest index down, releasing an element never moves another one still to be popped
+    std::sort(objs.begin(), objs.end(), std::greater<T*>());
+    for (T* obj : objs)
+    {
+        pop(obj);
+    }
+}
+
+template <pool_item_derived T, uint32_t N, uint8_t K>
+void multi_partitioned_growable_storage<T, N, K>::release(T* obj) noexcept
+{
+    assert(obj >= _data.data() && obj < _data.data() + size() && "Attempting to release an object from another storage");
+
+    // Carry the hole up, filling it with the last element of each partition
+    uint32_t hole = index(obj);
+    for (uint8_t current = partition(obj); current < K; ++current)
+    {
+        if (auto last = _ends[current] - 1; last != hole)
+        {
+            _data[hole] = std::move(_data[last]);
+            hole = last;
+        }
+
+        --_ends[current];
+    }
+
+    _data.pop_back();
+}
+
+template <pool_item_derived T, uint32_t N, uint8_t K>
+T* multi_partitioned_growable_storage<T, N, K>::change_partition(uint8_t partition, T* obj) noexcept
+{
+    assert(partition < K && "Partition out of bounds");
+
+    auto current = this->partition(obj);
+    assert(partition != current && "Can't change to the same partition");
+
+    auto position = index(obj);
+    if (partition > current)
+    {
+        // Swap with the last element and move the boundary down, once per partition
+        for (; current < partition; ++current)
+        {
+            if (auto last = _ends[current] - 1; last != position)
+            {
+                std::swap(_data[last], _data[position]);
+                position = last;
+            }
+
+            --_ends[current];
+        }
+    }
+    else
+    {
+        // Swap with the first element and move the boundary up, once per partition
+        for (; current > partition; --current)
+        {
+            if (auto first = begin(current); first != position)
+            {
+                std::swap(_data[first], _data[position]);
+                position = first;
+            }
+
+            ++_ends[current - 1];
+        }
+    }
+
+    return &_data[position];
+}
+
+template <pool_item_derived T, uint32_t N, uint8_t K>
+void multi_partitioned_growable_storage<T, N, K>::reserve(uint32_t count) noexcept
+{
+    if (auto needed = _data.size() + count; needed > _data.capacity())
+    {
+        _data.reserve(std::max(needed, _data.capacity() * 2));
+    }
+}
+
+template <pool_item_derived T, uint32_t N, uint8_t K>
+void multi_partitioned_growable_storage<T, N, K>::clear() noexcept
+{
+    for (auto& obj : _data)
+    {
+        static_cast<base_t&>(obj).base_destroy();
+        static_cast<base_t&>(obj).invalidate_ticket();
+    }
+
+    _data.clear();
+    _ends.fill(0);
+}
+
+template <pool_item_derived T, uint32_t N, uint8_t K>
+inline uint32_t multi_partitioned_growable_storage<T, N, K>::index(T* obj) const noexcept
+{
+    return static_cast<uint32_t>(obj - _data.data());
+}
+
+template <pool_item_derived T, uint32_t N, uint8_t K>
+inline uint32_t multi_partitioned_growable_storage<T, N, K>::size() const noexcept
+{
+    return _data.size();
+}
+
+template <pool_item_derived T, uint32_t N, uint8_t K>
+inline uint32_t multi_partitioned_growable_storage<T, N, K>::size(uint8_t partition) const noexcept
+{
+    return _ends[partition] - begin(partition);
+}
+
+template <pool_item_derived T, uint32_t N, uint8_t K>
+inline bool multi_partitioned_growable_storage<T, N, K>::empty() const noexcept
+{
+    return size() == 0;
+}
+
+template <pool_item_derived T, uint32_t N, uint8_t K>
+inline bool multi_partitioned_growable_storage<T, N, K>::full() const noexcept
+{
+    return false;
+}
+
+template <pool_item_derived T, uint32_t N, uint8_t K>
+inline uint8_t multi_partitioned_growable_storage<T, N, K>::partition(T* obj) const noexcept
+{
+    return static_cast<uint8_t>(std::upper_bound(_ends.begin(), _ends.end(), index(obj)) - _ends.begin());
+}
+
+template <pool_item_derived T, uint32_t N, uint8_t K>
+inline uint32_t multi_partitioned_growable_storage<T, N, K>::begin(uint8_t partition) const noexcept
+{
+    return partition == 0 ? 0 : _ends[partition - 1];
+}
@@ -0,0 +1,321 @@
+#pragma once
+
+#include "storage/storage.hpp"
+#include "storage/uninitialized_buffer.hpp"
+
+#include <range/v3/view/counted.hpp>
+#include <range/v3/view/iota.hpp>
+#include <range/v3/view/join.hpp>
+#include <range/v3/view/transform.hpp>
+
+#include <algorithm>
+#include <functional>
+#include <memory>
+#include <span>
+#include <vector>
+
+
+// Growable storage made of fixed pages of N elements. Growing only allocates a new page, thus
+// components are never relocated (nor their tickets refreshed) unless another one is popped
+template <pool_item_derived T, uint32_t N>
+class paged_growable_storage
+{
+    template <template <typename, uint32_t> typename storage, typename D, uint32_t M, template <typename> typename I>
+    friend class orchestrator;
+
+public:
+    static constexpr inline uint8_t tag = storage_tag(storage_grow::growable, storage_layout::continuous);
+
+    using base_t = component<T>;
+    using derived_t = T;
+    using orchestrator_t = orchestrator<paged_growable_storage, T, N>;
+
+    paged_growable_storage() noexcept;
+    ~paged_growable_storage() noexcept;
+
+    paged_growable_storage(paged_growable_storage&& other) noexcept;
+    paged_growable_storage& operator=(paged_growable_storage&& other) noexcept;
+
+    template <typename... Args>
+    T* push(Args&&... args) noexcept;
+    T* push_ptr(T* object) noexcept;
+
+    template <typename... Args>
+    void push_n(std::span<T*> out, std::span<const uint64_t> ids, const Args&... args) noexcept;
+
+    template <typename... Args>
+    void pop(T* obj, Args&&... args) noexcept;
+    void pop_n(std::span<T*> objs) noexcept;
+
+    // Makes room for `count` more elements at once
+    void reserve(uint32_t count) noexcept;
+
+    void clear() noexcept;
+
+    inline auto range() noexcept
+    {
+        return ranges::views::transform(
+            ranges::views::join(
+                ranges::views::transform(
+                    ranges::views::iota(static_cast<uint32_t>(0), page_count()),
+                    [this](uint32_t page) { return ranges::views::counted(_pages[page].data(), page_size(page)); })),
+            [](T& obj) { return &obj; });
+    }
+
+    inline auto spans() noexcept
+    {
+        return ranges::views::transform(
+            ranges::views::iota(static_cast<uint32_t>(0), page_count()),
+            [this](uint32_t page) { return std::span<T>(_pages[page].data(), page_size(page)); });
+    }
+
+    inline uint32_t index(T* obj) const noexcept;
+    inline T* at(uint32_t idx) const noexcept;
+
+    inline uint32_t size() const noexcept;
+    inline bool empty() const noexcept;
+    inline bool full() const noexcept;
+
+private:
+    void release(T* obj) noexcept;
+    T* next_slot() noexcept;
+
+    inline uint32_t page_count() const noexcept;
+    inline uint32_t page_size(uint32_t page) const noexcept;
+    inline uint32_t page_of(T* obj) const noexcept;
+    bool contains(T* obj) const noexcept;
+
+    void add_page() noexcept;
+    void remove_last_page() noexcept;
+
+private:
+    std::vector<uninitialized_buffer<T, N>> _pages;
+    uint32_t _size;
+
+    // Page addresses sorted, so that finding the page of an object is a binary search
+    std::vector<std::pair<T*, uint32_t>> _bases;
+};
+
+
+template <pool_item_derived T, uint32_t N>
+paged_growable_storage<T, N>::paged_growable_storage() noexcept :
+    _pages(),
+    _size(0),
+    _bases()
+{
+    add_page();
+}
+
+template <pool_item_derived T, uint32_t N>
+paged_growable_storage<T, N>::~paged_growable_storage() noexcept
+{
+    clear();
+}
+
+template <pool_item_derived T, uint32_t N>
+paged_growable_storage<T, N>::paged_growable_storage(paged_growable_storage&& other) noexcept :
+    _pages(std::move(other._pages)),
+    _size(std::exchange(other._size, 0)),
+    _bases(std::move(other._bases))
+{}
+
+template <pool_item_derived T, uint32_t N>
+paged_growable_storage<T, N>& paged_growable_storage<T, N>::operator=(paged_growable_storage&& other) noexcept
+{
+    clear();
+    std::swap(_pages, other._pages);
+    std::swap(_size, other._size);
+    std::swap(_bases, other._bases);
+    return *this;
+}
+
+template <pool_item_derived T, uint32_t N>
+template <typename... Args>
+T* paged_growable_storage<T, N>::push(Args&&... args) noexcept
+{
+    T* obj = new (next_slot()) T();
+    static_cast<base_t&>(*obj).recreate_ticket();
+    static_cast<base_t&>(*obj).base_construct(std::forward<Args>(args)...);
+    return obj;
+}
+
+template <pool_item_derived T, uint32_t N>
+T* paged_growable_storage<T, N>::push_ptr(T* object) noexcept
+{
+    return new (next_slot()) T(std::move(*object));
+}
+
+template <pool_item_derived T, uint32_t N>
+template <typename... Args>
+void paged_growable_storage<T, N>::push_n(std::span<T*> out, std::span<const uint64_t> ids, const Args&... args) noexcept
+{
+    assert(out.size() == ids.size() && "Output and ids sizes do not match");
+
+    _pages.reserve((_size + ids.size() + N - 1) / N);
+    for (std::size_t idx = 0; idx < ids.size(); ++idx)
+    {
+        out[idx] = new (next_slot()) T();
+    }
+
+    base_t::recreate_tickets(out);
+    for (std::size_t idx = 0; idx < ids.size(); ++idx)
+    {
+        static_cast<base_t&>(*out[idx]).base_construct(ids[idx], args...);
+    }
+}
+
+template <pool_item_derived T, uint32_t N>
+template <typename... Args>
+void paged_growable_storage<T, N>::pop(T* obj, Args&&... args) noexcept
+{
+    static_cast<base_t&>(*obj).base_destroy(std::forward<Args>(args)...);
+    static_cast<base_t&>(*obj).invalidate_ticket();
+    release(obj);
+}
+
+template <pool_item_derived T, uint32_t N>
+void paged_growable_storage<T, N>::pop_n(std::span<T*> objs) noexcept
+{
+    // From the highest index down, releasing an element never moves another one still to be popped
+    std::sort(objs.begin(), objs.end(), [this](T* a, T* b) { return index(a) > index(b); });
+    for (T* obj : objs)
+    {
+        pop(obj);
+    }
+}
+
+template <pool_item_derived T, uint32_t N>
+void paged_growable_storage<T, N>::release(T* obj) noexcept
+{
+    assert(contains(obj) && "Attempting to release an object from another storage");
+
+    if (auto candidate = at(--_size); obj != candidate)
+    {
+        *obj = std::move(*candidate);
+    }
+
+    std::destroy_at(at(_size));
+
+    // Keep one spare page around, so that pushing and popping at a page boundary does not allocate
+    if (_pages.size() * N - _size > 2 * N)
+    {
+        remove_last_page();
+    }
+}
+
+template <pool_item_derived T, uint32_t N>
+T* paged_growable_storage<T, N>::next_slot() noexcept
+{
+    if (_size == _pages.size() * N)
+    {
+        add_page();
+    }
+
+    return at(_size++);
+}
+
+template <pool_item_derived T, uint32_t N>
+void paged_growable_storage<T, N>::reserve(uint32_t count) noexcept
+{
+    // Pages never move, only the table pointing to them grows
+    _pages.reserve((_size + count + N - 1) / N);
+}
+
+template <pool_item_derived T, uint32_t N>
+void paged_growable_storage<T, N>::clear() noexcept
+{
+    for (auto obj : range())
+    {
+        static_cast<base_t&>(*obj).base_destroy();
+        static_cast<base_t&>(*obj).invalidate_ticket();
+        std::destroy_at(obj);
+    }
+
+    _size = 0;
+    while (_pages.size() > 1)
+    {
+        remove_last_page();
+    }
+}
+
+template <pool_item_derived T, uint32_t N>
+inline uint32_t paged_growable_storage<T, N>::index(T* obj) const noexcept
+{
+    auto page = page_of(obj);
+    assert(page != page_count() && "Object does not belong to this storage");
+    return page * N + static_cast<uint32_t>(obj - _pages[page].data());
+}
+
+template <pool_item_derived T, uint32_t N>
+inline T* paged_growable_storage<T, N>::at(uint32_t idx) const noexcept
+{
+    return _pages[idx / N].data() + idx % N;
+}
+
+template <pool_item_derived T, uint32_t N>
+inline uint32_t paged_growable_storage<T, N>::page_count() const noexcept
+{
+    return (_size + N - 1) / N;
+}
+
+template <pool_item_derived T, uint32_t N>
+inline uint32_t paged_growable_storage<T, N>::page_size(uint32_t page) const noexcept
+{
+    return std::min(N, _size - page * N);
+}
+
+template <pool_item_derived T, uint32_t N>
+bool paged_growable_storage<T, N>::contains(T* obj) const noexcept
+{
+    return page_of(obj) != page_count();
+}
+
+template <pool_item_derived T, uint32_t N>
+inline uint32_t paged_growable_storage<T, N>::page_of(T* obj) const noexcept
+{
+    // Last page starting at or before the object, if any, and only if the object is in its used part
+    auto it = std::upper_bound(_bases.begin(), _bases.end(), obj, [](T* obj, const auto& base) { return std::less<T*>()(obj, base.first); });
+    if (it != _bases.begin())
+    {
+        if (auto page = std::prev(it)->second; page < page_count() && obj < _pages[page].data() + page_size(page))
+        {
+            return page;
+        }
+    }
+
+    return page_count();
+}
+
+template <pool_item_derived T, uint32_t N>
+void paged_growable_storage<T, N>::add_page() noexcept
+{
+    auto& page = _pages.emplace_back();
+    auto base = std::make_pair(page.data(), static_cast<uint32_t>(_pages.size() - 1));
+    _bases.insert(std::upper_bound(_bases.begin(), _bases.end(), base, [](const auto& a, const auto& b) { return std::less<T*>()(a.first, b.first); }), base);
+}
+
+template <pool_item_derived T, uint32_t N>
+void paged_growable_storage<T, N>::remove_last_page() noexcept
+{
+    auto page = static_cast<uint32_t>(_pages.size() - 1);
+    _bases.erase(std::find_if(_bases.begin(), _bases.end(), [page](const auto& base) { return base.second == page; }));
+    _pages.pop_back();
+}
+
+template <pool_item_derived T, uint32_t N>
+inline uint32_t paged_growable_storage<T, N>::size() const noexcept
+{
+    return _size;
+}
+
+template <pool_item_derived T, uint32_t N>
+inline bool paged_growable_storage<T, N>::empty() const noexcept
+{
+    return size() == 0;
+}
+
+template <pool_item_derived T, uint32_t N>
+inline bool paged_growable_storage<T, N>::full() const noexcept
+{
+    return false;
+}
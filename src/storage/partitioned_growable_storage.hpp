@@ -5,14 +5,17 @@
 #include <range/v3/view/slice.hpp>
 #include <range/v3/view/transform.hpp>
 
+#include <algorithm>
 #include <array>
+#include <functional>
+#include <span>
 #include <vector>
 
 
 template <pool_item_derived T, uint32_t N>
 class partitioned_growable_storage
 {
-    template <template <typename, uint32_t> typename storage, typename D, uint32_t M>
+    template <template <typename, uint32_t> typename storage, typename D, uint32_t M, template <typename> typename I>
     friend class orchestrator;
     
 public:
@@ -32,8 +35,15 @@ public:
     T* push(bool predicate, Args&&... args) noexcept;
     T* push_ptr(bool predicate, T* object) noexcept;
 
+    template <typename... Args>
+    void push_n(std::span<T*> out, bool predicate, std::span<const uint64_t> ids, const Args&... args) noexcept;
+
     template <typename... Args>
     void pop(T* obj, Args&&... args) noexcept;
+    void pop_n(std::span<T*> objs) noexcept;
+
+    // Makes room for `count` more elements at once
+    void reserve(uint32_t count) noexcept;
 
     T* change_partition(bool predicate, T* obj) noexcept;
 
@@ -60,6 +70,22 @@ public:
             [](T& obj) { return &obj; });
     }
 
+    inline auto spans() noexcept
+    {
+        return std::array<std::span<T>, 1> { std::span<T>(_data) };
+    }
+
+    inline auto spans_until_partition() noexcept
+    {
+        return std::array<std::span<T>, 1> { std::span<T>(_data.data(), _partition_pos) };
+    }
+
+    inline auto spans_from_partition() noexcept
+    {
+        return std::array<std::span<T>, 1> { std::span<T>(_data.data() + _partition_pos, size_from_partition()) };
+    }
+
+    inline uint32_t index(T* obj) const noexcept;
     inline uint32_t size() const noexcept;
     inline uint32_t size_until_partition() const noexcept;
     inline uint32_t size_from_partition() const noexcept;
@@ -136,6 +162,40 @@ T* partitioned_growable_storage<T, N>::push_ptr(bool predicate, T* object) noexc
     return obj;
 }
 
+template <pool_item_derived T, uint32_t N>
+template <typename... Args>
+void partitioned_growable_storage<T, N>::push_n(std::span<T*> out, bool predicate, std::span<const uint64_t> ids, const Args&... args) noexcept
+{
+    assert(out.size() == ids.size() && "Output and ids sizes do not match");
+
+    const auto size = _data.size();
+    const auto count = ids.size();
+    _data.resize(size + count);
+
+    T* first = _data.data() + size;
+    if (predicate)
+    {
+        // Make room past the partition, moving as few elements as possible to the end
+        const auto moved = std::min<std::size_t>(count, size - _partition_pos);
+        T* from = _data.data() + _partition_pos;
+        std::move(from, from + moved, _data.data() + size + count - moved);
+
+        first = from;
+        _partition_pos += static_cast<uint32_t>(count);
+    }
+
+    for (std::size_t idx = 0; idx < count; ++idx)
+    {
+        out[idx] = first + idx;
+    }
+
+    base_t::recreate_tickets(out);
+    for (std::size_t idx = 0; idx < ids.size(); ++idx)
+    {
+        static_cast<base_t&>(*out[idx]).base_construct(ids[idx], args...);
+    }
+}
+
 template <pool_item_derived T, uint32_t N>
 template <typename... Args>
 void partitioned_growable_storage<T, N>::pop(T* obj, Args&&... args) noexcept
@@ -145,6 +205,17 @@ void partitioned_growable_storage<T, N>::pop(T* obj, Args&&... args) noexcept
     release(obj);
 }
 
+template <pool_item_derived T, uint32_t N>
+void partitioned_growable_storage<T, N>::pop_n(std::span<T*> objs) noexcept
+{
+    // From the highest index down, releasing an element never moves another one still to be popped
+    std::sort(objs.begin(), objs.end(), std::greater<T*>());
+    for (T* obj : objs)
+    {
+        pop(obj);
+    }
+}
+
 template <pool_item_derived T, uint32_t N>
 void partitioned_growable_storage<T, N>::release(T* obj) noexcept
 {
@@ -205,6 +276,15 @@ T* partitioned_growable_storage<T, N>::change_partition(bool predicate, T* obj)
     return obj;
 }
 
+template <pool_item_derived T, uint32_t N>
+void partitioned_growable_storage<T, N>::reserve(uint32_t count) noexcept
+{
+    if (auto needed = _data.size() + count; needed > _data.capacity())
+    {
+        _data.reserve(std::max(needed, _data.capacity() * 2));
+    }
+}
+
 template <pool_item_derived T, uint32_t N>
 void partitioned_growable_storage<T, N>::clear() noexcept
 {
@@ -215,6 +295,13 @@ void partitioned_growable_storage<T, N>::clear() noexcept
     }
 
     _data.clear();
+    _partition_pos = 0;
+}
+
+template <pool_item_derived T, uint32_t N>
+inline uint32_t partitioned_growable_storage<T, N>::index(T* obj) const noexcept
+{
+    return static_cast<uint32_t>(obj - _data.data());
 }
 
 template <pool_item_derived T, uint32_t N>
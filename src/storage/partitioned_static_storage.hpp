@@ -1,17 +1,22 @@
 #pragma once
 
 #include "storage/storage.hpp"
+#include "storage/uninitialized_buffer.hpp"
 
-#include <range/v3/view/slice.hpp>
+#include <range/v3/view/counted.hpp>
 #include <range/v3/view/transform.hpp>
 
+#include <algorithm>
 #include <array>
+#include <functional>
+#include <memory>
+#include <span>
 
 
 template <pool_item_derived T, uint32_t N>
 class partitioned_static_storage
 {
-    template <template <typename, uint32_t> typename storage, typename D, uint32_t M>
+    template <template <typename, uint32_t> typename storage, typename D, uint32_t M, template <typename> typename I>
     friend class orchestrator;
     
 public:
@@ -24,15 +29,22 @@ public:
     partitioned_static_storage() noexcept;
     ~partitioned_static_storage() noexcept;
 
-    partitioned_static_storage(partitioned_static_storage&& other) noexcept = default;
-    partitioned_static_storage& operator=(partitioned_static_storage&& other) noexcept = default;
+    partitioned_static_storage(partitioned_static_storage&& other) noexcept;
+    partitioned_static_storage& operator=(partitioned_static_storage&& other) noexcept;
 
     template <typename... Args>
     T* push(bool predicate, Args&&... args) noexcept;
     T* push_ptr(bool predicate, T* object) noexcept;
 
+    template <typename... Args>
+    void push_n(std::span<T*> out, bool predicate, std::span<const uint64_t> ids, const Args&... args) noexcept;
+
     template <typename... Args>
     void pop(T* obj, Args&&... args) noexcept;
+    void pop_n(std::span<T*> objs) noexcept;
+
+    // Makes room for `count` more elements at once
+    void reserve(uint32_t count) noexcept;
 
     T* change_partition(bool predicate, T* obj) noexcept;
     
@@ -41,24 +53,40 @@ public:
     inline auto range() noexcept
     {
         return ranges::views::transform(
-            ranges::views::slice(_data, static_cast<uint16_t>(0), static_cast<std::size_t>(_current - &_data[0])),
+            ranges::views::counted(_data.data(), size()),
             [](T& obj) { return &obj; });
     }
     
     inline auto range_until_partition() noexcept
     {
         return ranges::views::transform(
-            ranges::views::slice(_data, 0, static_cast<std::size_t>(_partition - &_data[0])),
+            ranges::views::counted(_data.data(), size_until_partition()),
             [](T& obj) { return &obj; });
     }
     
     inline auto range_from_partition() noexcept
     {
         return ranges::views::transform(
-            ranges::views::slice(_data, static_cast<std::size_t>(_partition - &_data[0]), static_cast<std::size_t>(_current - &_data[0])),
+            ranges::views::counted(_partition, size_from_partition()),
             [](T& obj) { return &obj; });
     }
 
+    inline auto spans() noexcept
+    {
+        return std::array<std::span<T>, 1> { std::span<T>(_data.data(), size()) };
+    }
+
+    inline auto spans_until_partition() noexcept
+    {
+        return std::array<std::span<T>, 1> { std::span<T>(_data.data(), size_until_partition()) };
+    }
+
+    inline auto spans_from_partition() noexcept
+    {
+        return std::array<std::span<T>, 1> { std::span<T>(_partition, size_from_partition()) };
+    }
+
+    inline uint32_t index(T* obj) const noexcept;
     inline uint32_t size() const noexcept;
     inline uint32_t size_until_partition() const noexcept;
     inline uint32_t size_from_partition() const noexcept;
@@ -71,7 +99,7 @@ private:
     void release(T* obj) noexcept;
 
 private:
-    std::array<T, N> _data;
+    uninitialized_buffer<T, N> _data;
     T* _current;
     T* _partition;
 };
@@ -80,10 +108,27 @@ private:
 template <pool_item_derived T, uint32_t N>
 partitioned_static_storage<T, N>::partitioned_static_storage() noexcept :
     _data(),
-    _current(&_data[0]),
-    _partition(&_data[0])
+    _current(_data.data()),
+    _partition(_data.data())
+{}
+
+template <pool_item_derived T, uint32_t N>
+partitioned_static_storage<T, N>::partitioned_static_storage(partitioned_static_storage&& other) noexcept :
+    _data(std::move(other._data)),
+    _current(std::exchange(other._current, nullptr)),
+    _partition(std::exchange(other._partition, nullptr))
 {}
 
+template <pool_item_derived T, uint32_t N>
+partitioned_static_storage<T, N>& partitioned_static_storage<T, N>::operator=(partitioned_static_storage&& other) noexcept
+{
+    clear();
+    _data = std::move(other._data);
+    std::swap(_current, other._current);
+    std::swap(_partition, other._partition);
+    return *this;
+}
+
 template <pool_item_derived T, uint32_t N>
 partitioned_static_storage<T, N>::~partitioned_static_storage() noexcept
 {
@@ -94,14 +139,15 @@ template <pool_item_derived T, uint32_t N>
 template <typename... Args>
 T* partitioned_static_storage<T, N>::push(bool predicate, Args&&... args) noexcept
 {
-    assert(_current < &_data[0] + N && "Writing out of bounds");
+    assert(_current < _data.end() && "Writing out of bounds");
     T* obj = _current;
     if (predicate)
     {
         // Move partition to last
         if (_current != _partition)
         {
-            *_current = std::move(*_partition);
+            new (_current) T(std::move(*_partition));
+            std::destroy_at(_partition);
         }
 
         // Increment partition and write
@@ -109,6 +155,7 @@ T* partitioned_static_storage<T, N>::push(bool predicate, Args&&... args) noexce
     }
 
     ++_current;
+    new (obj) T();
     static_cast<base_t&>(*obj).recreate_ticket();
     static_cast<base_t&>(*obj).base_construct(std::forward<Args>(args)...);
     return obj;
@@ -117,14 +164,15 @@ T* partitioned_static_storage<T, N>::push(bool predicate, Args&&... args) noexce
 template <pool_item_derived T, uint32_t N>
 T* partitioned_static_storage<T, N>::push_ptr(bool predicate, T* object) noexcept
 {
-    assert(_current < &_data[0] + N && "Writing out of bounds");
+    assert(_current < _data.end() && "Writing out of bounds");
     T* obj = _current;
     if (predicate)
     {
         // Move partition to last
         if (_current != _partition)
         {
-            *_current = std::move(*_partition);
+            new (_current) T(std::move(*_partition));
+            std::destroy_at(_partition);
         }
 
         // Increment partition and write
@@ -132,12 +180,44 @@ T* partitioned_static_storage<T, N>::push_ptr(bool predicate, T* object) noexcep
     }
 
     ++_current;
-    if (obj != object)
+    new (obj) T(std::move(*object));
+    return obj;
+}
+
+template <pool_item_derived T, uint32_t N>
+template <typename... Args>
+void partitioned_static_storage<T, N>::push_n(std::span<T*> out, bool predicate, std::span<const uint64_t> ids, const Args&... args) noexcept
+{
+    assert(out.size() == ids.size() && "Output and ids sizes do not match");
+    assert(_current + ids.size() <= _data.end() && "Writing out of bounds");
+
+    const auto count = ids.size();
+    T* first = _current;
+    if (predicate)
     {
-        *obj = std::move(*object);
+        // Make room past the partition, moving as few elements as possible to the end
+        const auto moved = std::min<std::size_t>(count, _current - _partition);
+        for (T* from = _partition, *to = _current + count - moved; from != _partition + moved; ++from, ++to)
+        {
+            new (to) T(std::move(*from));
+            std::destroy_at(from);
+        }
+
+        first = _partition;
+        _partition += count;
     }
 
-    return obj;
+    _current += count;
+    for (std::size_t idx = 0; idx < count; ++idx)
+    {
+        out[idx] = new (first + idx) T();
+    }
+
+    base_t::recreate_tickets(out);
+    for (std::size_t idx = 0; idx < ids.size(); ++idx)
+    {
+        static_cast<base_t&>(*out[idx]).base_construct(ids[idx], args...);
+    }
 }
 
 template <pool_item_derived T, uint32_t N>
@@ -149,10 +229,21 @@ void partitioned_static_storage<T, N>::pop(T* obj, Args&&... args) noexcept
     release(obj);
 }
 
+template <pool_item_derived T, uint32_t N>
+void partitioned_static_storage<T, N>::pop_n(std::span<T*> objs) noexcept
+{
+    // From the highest index down, releasing an element never moves another one still to be popped
+    std::sort(objs.begin(), objs.end(), std::greater<T*>());
+    for (T* obj : objs)
+    {
+        pop(obj);
+    }
+}
+
 template <pool_item_derived T, uint32_t N>
 void partitioned_static_storage<T, N>::release(T* obj) noexcept
 {
-    assert(obj >= &_data[0] && obj < &_data[0] + size() && "Attempting to release an object from another storage");
+    assert(obj >= _data.data() && obj < _current && "Attempting to release an object from another storage");
 
     if (partition(obj))
     {
@@ -172,6 +263,8 @@ void partitioned_static_storage<T, N>::release(T* obj) noexcept
     {
         *obj = std::move(*_current);
     }
+
+    std::destroy_at(_current);
 }
 
 template <pool_item_derived T, uint32_t N>
@@ -195,7 +288,7 @@ T* partitioned_static_storage<T, N>::change_partition(bool predicate, T* obj) no
     {
         if (auto candidate = _partition - 1; obj != candidate)
         {
-            std::swap(candidate, obj);
+            std::swap(*candidate, *obj);
         }
 
         // Move partition
@@ -206,6 +299,12 @@ T* partitioned_static_storage<T, N>::change_partition(bool predicate, T* obj) no
     return obj;
 }
 
+template <pool_item_derived T, uint32_t N>
+void partitioned_static_storage<T, N>::reserve(uint32_t count) noexcept
+{
+    // Fixed capacity, elements never move
+}
+
 template <pool_item_derived T, uint32_t N>
 void partitioned_static_storage<T, N>::clear() noexcept
 {
@@ -213,27 +312,34 @@ void partitioned_static_storage<T, N>::clear() noexcept
     {
         static_cast<base_t&>(*obj).base_destroy();
         static_cast<base_t&>(*obj).invalidate_ticket();
+        std::destroy_at(obj);
     }
 
-    _current = _partition = &_data[0];
+    _current = _partition = _data.data();
+}
+
+template <pool_item_derived T, uint32_t N>
+inline uint32_t partitioned_static_storage<T, N>::index(T* obj) const noexcept
+{
+    return static_cast<uint32_t>(obj - _data.data());
 }
 
 template <pool_item_derived T, uint32_t N>
 inline uint32_t partitioned_static_storage<T, N>::size() const noexcept
 {
-    return _current - &_data[0];
+    return _current - _data.data();
 }
 
 template <pool_item_derived T, uint32_t N>
 inline uint32_t partitioned_static_storage<T, N>::size_until_partition() const noexcept
 {
-    return _partition - &_data[0];
+    return _partition - _data.data();
 }
 
 template <pool_item_derived T, uint32_t N>
 inline uint32_t partitioned_static_storage<T, N>::size_from_partition() const noexcept
 {
-    return _partition - _current;
+    return _current - _partition;
 }
 
 template <pool_item_derived T, uint32_t N>
@@ -245,7 +351,7 @@ inline bool partitioned_static_storage<T, N>::empty() const noexcept
 template <pool_item_derived T, uint32_t N>
 inline bool partitioned_static_storage<T, N>::full() const noexcept
 {
-    return _current == &_data[0] + N;
+    return _current == _data.end();
 }
 
 template <pool_item_derived T, uint32_t N>
@@ -1,7 +1,10 @@
 #pragma once
 
+#include "storage/handle.hpp"
 #include "storage/ticket.hpp"
 
+#include <span>
+
 
 template <typename T>
 class pool_item
@@ -17,29 +20,28 @@ public:
 
     inline bool has_ticket() const noexcept;
     inline const typename ticket<T>::ptr& ticket() const noexcept;
+    inline ::handle<T> handle() const noexcept;
 
     inline void refresh_ticket() noexcept;
 
 protected:
     inline void recreate_ticket() noexcept;
     inline void invalidate_ticket() noexcept;
+
+    template <typename D>
+    static void recreate_tickets(std::span<D*> items) noexcept;
+
     void invalidate() noexcept;
 
 private:
-#ifndef UMI_DEFAULT_TICKETS_TO_NULLPTR
-    static inline auto _default_ticket = typename ::ticket<T>::ptr(new ::ticket<T>(nullptr));
-#endif
-
-   typename ::ticket<T>::ptr _ticket;
+    // Default constructed items hold no ticket at all, copying a shared default one would
+    //  make every construction contend on its refcount
+    typename ::ticket<T>::ptr _ticket;
 };
 
 template <typename T>
 pool_item<T>::pool_item() noexcept :
-#ifndef UMI_DEFAULT_TICKETS_TO_NULLPTR
-    _ticket(_default_ticket)
-#else 
     _ticket(nullptr)
-#endif
 {}
 
 template <typename T>
@@ -69,16 +71,43 @@ inline const typename ticket<T>::ptr& pool_item<T>::ticket() const noexcept
     return _ticket; 
 }
 
+template <typename T>
+inline ::handle<T> pool_item<T>::handle() const noexcept
+{
+    if (!_ticket)
+    {
+        return ::handle<T>();
+    }
+
+    return ::handle<T>(_ticket->_slot, _ticket->_generation.load(std::memory_order_relaxed));
+}
+
 template <typename T>
 inline void pool_item<T>::recreate_ticket() noexcept
 {
-    _ticket = typename ::ticket<T>::ptr(new ::ticket<T>(reinterpret_cast<T*>(this)));
+    _ticket = ::ticket<T>::make(reinterpret_cast<T*>(this));
+}
+
+template <typename T>
+template <typename D>
+void pool_item<T>::recreate_tickets(std::span<D*> items) noexcept
+{
+    auto item = items.begin();
+    slot_table<T>::instance().acquire_n(static_cast<uint32_t>(items.size()), [&item](::ticket<T>* ticket) {
+        pool_item& current = **item++;
+        ticket->_ptr = reinterpret_cast<T*>(&current);
+        current._ticket = typename ::ticket<T>::ptr(ticket);
+    });
 }
 
 template <typename T>
 inline void pool_item<T>::refresh_ticket() noexcept
 {
-    _ticket->_ptr = reinterpret_cast<T*>(this);
+    // Moving default constructed (ie. not yet pushed) items is allowed
+    if (_ticket)
+    {
+        _ticket->_ptr = reinterpret_cast<T*>(this);
+    }
 }
 
 template <typename T>
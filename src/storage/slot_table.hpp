@@ -0,0 +1,248 @@
+#pragma once
+
+#include <synchronization/mutex.hpp>
+
+#include <array>
+#include <atomic>
+#include <cassert>
+#include <inttypes.h>
+#include <new>
+#include <vector>
+
+
+template <typename T>
+class ticket;
+
+
+struct slot_table_stats
+{
+    // Each page is exactly one heap allocation, once warm this must stay constant
+    uint32_t pages;
+    uint64_t bytes;
+    uint32_t slots;
+    uint32_t free;
+};
+
+
+// Stable, paged storage for all tickets of a given type. Slots are only recycled once every
+// reference to its ticket is gone, and each reuse bumps the slot generation, so a (slot, generation)
+// pair is enough to tell whether a component is still alive
+//
+// Each thread keeps a small cache of free slots, so that acquiring and releasing tickets only locks
+// once every `cache_batch` operations, regardless of how many storages share the type
+template <typename T>
+class slot_table
+{
+    static constexpr inline uint32_t page_bits = 12;
+    static constexpr inline uint32_t page_size = 1 << page_bits;
+    static constexpr inline uint32_t page_mask = page_size - 1;
+    static constexpr inline uint32_t max_pages = 1 << 14;
+
+    static constexpr inline uint32_t cache_batch = 64;
+
+    struct local_cache
+    {
+        local_cache() noexcept;
+        ~local_cache() noexcept;
+
+        std::vector<uint32_t> slots;
+    };
+
+public:
+    static inline slot_table& instance() noexcept;
+
+    ticket<T>* acquire(T* ptr) noexcept;
+    void release(ticket<T>* ticket) noexcept;
+
+    // Acquires `count` tickets locking at most once, `assign` must set each ticket pointer
+    template <typename F>
+    void acquire_n(uint32_t count, F&& assign) noexcept;
+
+    inline ticket<T>* at(uint32_t slot) const noexcept;
+    inline uint32_t capacity() const noexcept;
+
+    slot_table_stats stats() noexcept;
+
+private:
+    slot_table() noexcept;
+
+    inline uint32_t take_slot() noexcept;
+    void allocate_page() noexcept;
+
+    static inline local_cache& cache() noexcept;
+
+private:
+    np::mutex _mutex;
+    std::array<ticket<T>*, max_pages> _pages;
+    std::atomic<uint32_t> _next;
+    std::vector<uint32_t> _free;
+};
+
+
+template <typename T>
+slot_table<T>::slot_table() noexcept :
+    _pages(),
+    _next(0),
+    _free()
+{}
+
+template <typename T>
+inline slot_table<T>& slot_table<T>::instance() noexcept
+{
+    // Never destroyed on purpose, tickets held by statics may outlive it otherwise
+    static slot_table* table = new slot_table();
+    return *table;
+}
+
+template <typename T>
+ticket<T>* slot_table<T>::acquire(T* ptr) noexcept
+{
+    auto& local = cache();
+    if (local.slots.empty())
+    {
+        _mutex.lock();
+        for (uint32_t i = 0; i < cache_batch; ++i)
+        {
+            local.slots.push_back(take_slot());
+        }
+        _mutex.unlock();
+    }
+
+    uint32_t slot = local.slots.back();
+    local.slots.pop_back();
+
+    auto ticket = at(slot);
+    ticket->_ptr = ptr;
+    return ticket;
+}
+
+template <typename T>
+template <typename F>
+void slot_table<T>::acquire_n(uint32_t count, F&& assign) noexcept
+{
+    auto& local = cache();
+    for (; count > 0 && !local.slots.empty(); --count)
+    {
+        assign(at(local.slots.back()));
+        local.slots.pop_back();
+    }
+
+    if (count == 0)
+    {
+        return;
+    }
+
+    _mutex.lock();
+    for (uint32_t i = 0; i < count; ++i)
+    {
+        assign(at(take_slot()));
+    }
+    _mutex.unlock();
+}
+
+template <typename T>
+void slot_table<T>::release(ticket<T>* ticket) noexcept
+{
+    // Outstanding handles to this slot must not see the next owner
+    ticket->_generation.fetch_add(1, std::memory_order_relaxed);
+    ticket->_ptr = nullptr;
+
+    auto& local = cache();
+    local.slots.push_back(ticket->_slot);
+
+    // Give back a batch, otherwise threads that only release would hoard slots
+    if (local.slots.size() >= cache_batch * 2)
+    {
+        _mutex.lock();
+        _free.insert(_free.end(), local.slots.end() - cache_batch, local.slots.end());
+        _mutex.unlock();
+
+        local.slots.resize(cache_batch);
+    }
+}
+
+template <typename T>
+inline ticket<T>* slot_table<T>::at(uint32_t slot) const noexcept
+{
+    return _pages[slot >> page_bits] + (slot & page_mask);
+}
+
+template <typename T>
+inline uint32_t slot_table<T>::capacity() const noexcept
+{
+    return _next;
+}
+
+template <typename T>
+slot_table_stats slot_table<T>::stats() noexcept
+{
+    _mutex.lock();
+    uint32_t slots = _next;
+    uint32_t pages = (slots + page_mask) >> page_bits;
+    slot_table_stats stats {
+        .pages = pages,
+        .bytes = static_cast<uint64_t>(pages) * page_size * sizeof(ticket<T>),
+        .slots = slots,
+        .free = static_cast<uint32_t>(_free.size())
+    };
+    _mutex.unlock();
+
+    return stats;
+}
+
+template <typename T>
+inline uint32_t slot_table<T>::take_slot() noexcept
+{
+    // Must be called with the mutex held
+    if (_free.empty())
+    {
+        if ((_next & page_mask) == 0)
+        {
+            allocate_page();
+        }
+
+        return _next++;
+    }
+
+    uint32_t slot = _free.back();
+    _free.pop_back();
+    return slot;
+}
+
+template <typename T>
+void slot_table<T>::allocate_page() noexcept
+{
+    auto index = _next >> page_bits;
+    assert(index < max_pages && "Ran out of ticket slots");
+
+    auto page = static_cast<ticket<T>*>(::operator new(sizeof(ticket<T>) * page_size));
+    for (uint32_t i = 0; i < page_size; ++i)
+    {
+        new (page + i) ticket<T>(nullptr, _next + i);
+    }
+
+    _pages[index] = page;
+}
+
+template <typename T>
+slot_table<T>::local_cache::local_cache() noexcept :
+    slots()
+{
+    slots.reserve(cache_batch * 2);
+}
+
+template <typename T>
+slot_table<T>::local_cache::~local_cache() noexcept
+{
+    auto& table = slot_table<T>::instance();
+    table._mutex.lock();
+    table._free.insert(table._free.end(), slots.begin(), slots.end());
+    table._mutex.unlock();
+}
+
+template <typename T>
+inline typename slot_table<T>::local_cache& slot_table<T>::cache() noexcept
+{
+    thread_local local_cache cache;
+    return cache;
+}
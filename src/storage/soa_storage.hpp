@@ -0,0 +1,288 @@
+#pragma once
+
+#include "concepts/has_soa_fields.hpp"
+#include "storage/aligned_allocator.hpp"
+#include "storage/storage.hpp"
+
+#include <range/v3/view/transform.hpp>
+
+#include <algorithm>
+#include <array>
+#include <functional>
+#include <span>
+#include <tuple>
+#include <utility>
+#include <vector>
+
+
+template <typename F>
+struct soa_columns;
+
+template <typename... Fs>
+struct soa_columns<std::tuple<Fs...>>
+{
+    using type = std::tuple<std::vector<Fs, aligned_allocator<Fs>>...>;
+    using refs = std::tuple<Fs&...>;
+};
+
+
+// Growable storage that keeps the fields listed in `T::soa_fields` out of the component, each in
+// its own aligned array. Columns are kept in the same order as the components, so that the i-th
+// element of every `field<I>()` span belongs to the i-th component of `range()`
+template <pool_item_derived T, uint32_t N>
+class soa_storage
+{
+    template <template <typename, uint32_t> typename storage, typename D, uint32_t M, template <typename> typename I>
+    friend class orchestrator;
+
+    static_assert(has_soa_fields_v<T>, "SoA storages require components to declare `soa_fields`");
+
+public:
+    static constexpr inline uint8_t tag = storage_tag(storage_grow::growable, storage_layout::continuous) |
+        storage_tag(storage_grow::none, storage_layout::soa);
+
+    using base_t = component<T>;
+    using derived_t = T;
+    using orchestrator_t = orchestrator<soa_storage, T, N>;
+    using fields_t = typename T::soa_fields;
+    using columns_t = typename soa_columns<fields_t>::type;
+    using field_refs_t = typename soa_columns<fields_t>::refs;
+
+    template <std::size_t I>
+    using field_t = std::tuple_element_t<I, fields_t>;
+
+    soa_storage() noexcept;
+    ~soa_storage() noexcept;
+
+    soa_storage(soa_storage&& other) noexcept = default;
+    soa_storage& operator=(soa_storage&& other) noexcept = default;
+
+    template <typename... Args>
+    T* push(Args&&... args) noexcept;
+    T* push_ptr(T* object) noexcept;
+    T* push_ptr(T* object, field_refs_t fields) noexcept;
+
+    template <typename... Args>
+    void push_n(std::span<T*> out, std::span<const uint64_t> ids, const Args&... args) noexcept;
+
+    template <typename... Args>
+    void pop(T* obj, Args&&... args) noexcept;
+    void pop_n(std::span<T*> objs) noexcept;
+
+    // Makes room for `count` more elements at once
+    void reserve(uint32_t count) noexcept;
+
+    void clear() noexcept;
+
+    inline auto range() noexcept
+    {
+        return ranges::views::transform(
+            _data,
+            [](T& obj) { return &obj; });
+    }
+
+    inline auto spans() noexcept
+    {
+        return std::array<std::span<T>, 1> { std::span<T>(_data) };
+    }
+
+    template <std::size_t I>
+    inline std::span<field_t<I>> field() noexcept
+    {
+        return std::span<field_t<I>>(std::get<I>(_columns));
+    }
+
+    template <std::size_t I>
+    inline field_t<I>& field(T* obj) noexcept
+    {
+        return std::get<I>(_columns)[index(obj)];
+    }
+
+    inline field_refs_t fields(T* obj) noexcept;
+
+    // Swaps both objects along with their fields
+    void swap(T* a, T* b) noexcept;
+
+    inline uint32_t index(T* obj) const noexcept;
+    inline T* at(uint32_t idx) noexcept;
+    inline uint32_t size() const noexcept;
+    inline bool empty() const noexcept;
+    inline bool full() const noexcept;
+
+private:
+    void release(T* obj) noexcept;
+
+private:
+    std::vector<T> _data;
+    columns_t _columns;
+};
+
+
+template <pool_item_derived T, uint32_t N>
+soa_storage<T, N>::soa_storage() noexcept :
+    _data(),
+    _columns()
+{
+    _data.reserve(N);
+    std::apply([](auto&... column) { (column.reserve(N), ...); }, _columns);
+}
+
+template <pool_item_derived T, uint32_t N>
+soa_storage<T, N>::~soa_storage() noexcept
+{
+    clear();
+}
+
+template <pool_item_derived T, uint32_t N>
+template <typename... Args>
+T* soa_storage<T, N>::push(Args&&... args) noexcept
+{
+    T* obj = &_data.emplace_back();
+    std::apply([](auto&... column) { (column.emplace_back(), ...); }, _columns);
+
+    static_cast<base_t&>(*obj).recreate_ticket();
+    static_cast<base_t&>(*obj).base_construct(std::forward<Args>(args)...);
+    return obj;
+}
+
+template <pool_item_derived T, uint32_t N>
+T* soa_storage<T, N>::push_ptr(T* object) noexcept
+{
+    // Coming from an AoS storage, there is nothing to carry over
+    std::apply([](auto&... column) { (column.emplace_back(), ...); }, _columns);
+    return &_data.emplace_back(std::move(*object));
+}
+
+template <pool_item_derived T, uint32_t N>
+T* soa_storage<T, N>::push_ptr(T* object, field_refs_t fields) noexcept
+{
+    [this, &fields]<std::size_t... I>(std::index_sequence<I...>) {
+        (std::get<I>(_columns).emplace_back(std::move(std::get<I>(fields))), ...);
+    }(std::make_index_sequence<std::tuple_size_v<fields_t>>{});
+
+    return &_data.emplace_back(std::move(*object));
+}
+
+template <pool_item_derived T, uint32_t N>
+template <typename... Args>
+void soa_storage<T, N>::push_n(std::span<T*> out, std::span<const uint64_t> ids, const Args&... args) noexcept
+{
+    assert(out.size() == ids.size() && "Output and ids sizes do not match");
+
+    const auto first = _data.size();
+    _data.resize(first + ids.size());
+    std::apply([size = _data.size()](auto&... column) { (column.resize(size), ...); }, _columns);
+    for (std::size_t idx = 0; idx < ids.size(); ++idx)
+    {
+        out[idx] = &_data[first + idx];
+    }
+
+    base_t::recreate_tickets(out);
+    for (std::size_t idx = 0; idx < ids.size(); ++idx)
+    {
+        static_cast<base_t&>(*out[idx]).base_construct(ids[idx], args...);
+    }
+}
+
+template <pool_item_derived T, uint32_t N>
+template <typename... Args>
+void soa_storage<T, N>::pop(T* obj, Args&&... args) noexcept
+{
+    static_cast<base_t&>(*obj).base_destroy(std::forward<Args>(args)...);
+    static_cast<base_t&>(*obj).invalidate_ticket();
+
+    release(obj);
+}
+
+template <pool_item_derived T, uint32_t N>
+void soa_storage<T, N>::pop_n(std::span<T*> objs) noexcept
+{
+    // From the highest index down, releasing an element never moves another one still to be popped
+    std::sort(objs.begin(), objs.end(), std::greater<T*>());
+    for (T* obj : objs)
+    {
+        pop(obj);
+    }
+}
+
+template <pool_item_derived T, uint32_t N>
+void soa_storage<T, N>::release(T* obj) noexcept
+{
+    assert(obj >= &_data[0] && obj < &_data[0] + size() && "Attempting to release an object from another storage");
+
+    if (auto idx = index(obj); obj != &_data.back())
+    {
+        *obj = std::move(_data.back());
+        std::apply([idx](auto&... column) { ((column[idx] = std::move(column.back())), ...); }, _columns);
+    }
+
+    _data.pop_back();
+    std::apply([](auto&... column) { (column.pop_back(), ...); }, _columns);
+}
+
+template <pool_item_derived T, uint32_t N>
+void soa_storage<T, N>::reserve(uint32_t count) noexcept
+{
+    if (auto needed = _data.size() + count; needed > _data.capacity())
+    {
+        needed = std::max(needed, _data.capacity() * 2);
+        _data.reserve(needed);
+        std::apply([needed](auto&... column) { (column.reserve(needed), ...); }, _columns);
+    }
+}
+
+template <pool_item_derived T, uint32_t N>
+void soa_storage<T, N>::clear() noexcept
+{
+    for (auto obj : range())
+    {
+        static_cast<base_t&>(*obj).base_destroy();
+        static_cast<base_t&>(*obj).invalidate_ticket();
+    }
+
+    _data.clear();
+    std::apply([](auto&... column) { (column.clear(), ...); }, _columns);
+}
+
+template <pool_item_derived T, uint32_t N>
+inline typename soa_storage<T, N>::field_refs_t soa_storage<T, N>::fields(T* obj) noexcept
+{
+    return std::apply([idx = index(obj)](auto&... column) { return field_refs_t(column[idx]...); }, _columns);
+}
+
+template <pool_item_derived T, uint32_t N>
+void soa_storage<T, N>::swap(T* a, T* b) noexcept
+{
+    std::apply([a = index(a), b = index(b)](auto&... column) { (std::swap(column[a], column[b]), ...); }, _columns);
+    std::swap(*a, *b);
+}
+
+template <pool_item_derived T, uint32_t N>
+inline uint32_t soa_storage<T, N>::index(T* obj) const noexcept
+{
+    return static_cast<uint32_t>(obj - _data.data());
+}
+
+template <pool_item_derived T, uint32_t N>
+inline T* soa_storage<T, N>::at(uint32_t idx) noexcept
+{
+    return &_data[idx];
+}
+
+template <pool_item_derived T, uint32_t N>
+inline uint32_t soa_storage<T, N>::size() const noexcept
+{
+    return static_cast<uint32_t>(_data.size());
+}
+
+template <pool_item_derived T, uint32_t N>
+inline bool soa_storage<T, N>::empty() const noexcept
+{
+    return size() == 0;
+}
+
+template <pool_item_derived T, uint32_t N>
+inline bool soa_storage<T, N>::full() const noexcept
+{
+    return false;
+}
@@ -0,0 +1,262 @@
+#pragma once
+
+#include "common/prefetch.hpp"
+#include "storage/ticket.hpp"
+
+#include <algorithm>
+#include <cassert>
+#include <inttypes.h>
+#include <limits>
+#include <memory>
+#include <unordered_map>
+#include <vector>
+
+
+template <typename T>
+class component;
+
+
+// Maps entity ids to dense slots through a paged sparse array. A lookup reads the page, its slot and
+// the dense entry, then resolves the entry's ticket. Emptied pages are recycled, so steady-state
+// push/pop do not allocate as long as ids are densely generated (ie. by `generator`).
+// The page table grows up to the highest id, thus it only covers ids up to `max_id`. Larger ids fall
+// back to a hash map, use `map_index` for sparse or hashed ids
+template <typename T>
+class sparse_set_index
+{
+    static constexpr inline uint32_t page_bits = 12;
+    static constexpr inline uint32_t page_size = 1 << page_bits;
+    static constexpr inline uint32_t page_mask = page_size - 1;
+    static constexpr inline uint32_t npos = std::numeric_limits<uint32_t>::max();
+
+public:
+    // At most 8MB of page pointers
+    static constexpr inline uint64_t max_id = (uint64_t(1) << 32) - 1;
+
+private:
+
+    using ticket_t = ::ticket<component<typename T::derived_t>>;
+
+    struct page
+    {
+        uint32_t slots[page_size];
+        uint32_t used;
+    };
+
+    struct entry
+    {
+        uint64_t id;
+        // Orchestrators erase ids before popping, thus the component always outlives this reference
+        ticket_t* ticket;
+    };
+
+public:
+    sparse_set_index(uint32_t capacity) noexcept;
+
+    sparse_set_index(sparse_set_index&& other) noexcept = default;
+    sparse_set_index& operator=(sparse_set_index&& other) noexcept = default;
+
+    inline T* get(uint64_t id) const noexcept;
+    inline void insert(T* obj) noexcept;
+    inline void erase(uint64_t id) noexcept;
+    void clear() noexcept;
+
+    // Makes room for `count` more ids at once
+    inline void reserve(uint32_t count) noexcept;
+
+    inline uint32_t size() const noexcept;
+
+    // A lookup chains three loads, these start the first two so that batched lookups can overlap them.
+    // `prefetch_entry` reads the slot, thus `prefetch` the id beforehand
+    inline void prefetch(uint64_t id) const noexcept;
+    inline void prefetch_entry(uint64_t id) const noexcept;
+
+private:
+    inline uint32_t* find_slot(uint64_t id) const noexcept;
+    uint32_t* acquire_slot(uint64_t id) noexcept;
+    inline void release_slot(uint64_t id) noexcept;
+
+private:
+    std::vector<std::unique_ptr<page>> _pages;
+    std::vector<std::unique_ptr<page>> _free_pages;
+    std::vector<entry> _dense;
+
+    // Slots of ids beyond `max_id`
+    std::unordered_map<uint64_t, uint32_t> _overflow;
+};
+
+
+template <typename T>
+sparse_set_index<T>::sparse_set_index(uint32_t capacity) noexcept :
+    _pages(),
+    _free_pages(),
+    _dense(),
+    _overflow()
+{
+    _dense.reserve(capacity);
+}
+
+template <typename T>
+inline T* sparse_set_index<T>::get(uint64_t id) const noexcept
+{
+    if (auto slot = find_slot(id); slot && *slot != npos)
+    {
+        assert(_dense[*slot].ticket->valid() && "Orchestrator has an invalid ticket");
+        return _dense[*slot].ticket->get()->derived();
+    }
+
+    return nullptr;
+}
+
+template <typename T>
+inline void sparse_set_index<T>::insert(T* obj) noexcept
+{
+    uint32_t* slot = acquire_slot(obj->id());
+    assert(*slot == npos && "Id is already present in the index");
+
+    *slot = static_cast<uint32_t>(_dense.size());
+    _dense.push_back({ obj->id(), obj->ticket().get() });
+}
+
+template <typename T>
+inline void sparse_set_index<T>::erase(uint64_t id) noexcept
+{
+    uint32_t* slot = find_slot(id);
+    if (!slot || *slot == npos)
+    {
+        return;
+    }
+
+    // Swap with the last dense entry to keep it packed
+    if (auto& last = _dense.back(); last.id != id)
+    {
+        _dense[*slot] = last;
+        *find_slot(last.id) = *slot;
+    }
+
+    _dense.pop_back();
+    release_slot(id);
+}
+
+template <typename T>
+void sparse_set_index<T>::clear() noexcept
+{
+    for (auto& entry : _dense)
+    {
+        release_slot(entry.id);
+    }
+
+    _dense.clear();
+    _overflow.clear();
+}
+
+template <typename T>
+inline void sparse_set_index<T>::reserve(uint32_t count) noexcept
+{
+    if (auto needed = _dense.size() + count; needed > _dense.capacity())
+    {
+        _dense.reserve(std::max(needed, _dense.capacity() * 2));
+    }
+}
+
+template <typename T>
+inline uint32_t sparse_set_index<T>::size() const noexcept
+{
+    return static_cast<uint32_t>(_dense.size());
+}
+
+template <typename T>
+inline void sparse_set_index<T>::prefetch(uint64_t id) const noexcept
+{
+    // Overflowing ids are rare enough not to be worth a walk of their bucket
+    if (id <= max_id)
+    {
+        if (auto slot = find_slot(id))
+        {
+            ::prefetch(slot);
+        }
+    }
+}
+
+template <typename T>
+inline void sparse_set_index<T>::prefetch_entry(uint64_t id) const noexcept
+{
+    if (auto slot = find_slot(id); slot && *slot != npos)
+    {
+        ::prefetch(&_dense[*slot]);
+    }
+}
+
+template <typename T>
+inline uint32_t* sparse_set_index<T>::find_slot(uint64_t id) const noexcept
+{
+    if (id > max_id) [[unlikely]]
+    {
+        auto it = _overflow.find(id);
+        return it != _overflow.end() ? const_cast<uint32_t*>(&it->second) : nullptr;
+    }
+
+    if (auto idx = id >> page_bits; idx < _pages.size())
+    {
+        if (page* p = _pages[idx].get())
+        {
+            return &p->slots[id & page_mask];
+        }
+    }
+
+    return nullptr;
+}
+
+template <typename T>
+uint32_t* sparse_set_index<T>::acquire_slot(uint64_t id) noexcept
+{
+    if (id > max_id) [[unlikely]]
+    {
+        // Node based, thus the slot stays put while other ids come and go
+        return &_overflow.try_emplace(id, npos).first->second;
+    }
+
+    auto idx = id >> page_bits;
+    if (idx >= _pages.size())
+    {
+        _pages.resize(idx + 1);
+    }
+
+    auto& p = _pages[idx];
+    if (!p)
+    {
+        if (_free_pages.empty())
+        {
+            p = std::make_unique<page>();
+            std::fill(std::begin(p->slots), std::end(p->slots), npos);
+            p->used = 0;
+        }
+        else
+        {
+            // Recycled pages are already fully reset
+            p = std::move(_free_pages.back());
+            _free_pages.pop_back();
+        }
+    }
+
+    ++p->used;
+    return &p->slots[id & page_mask];
+}
+
+template <typename T>
+inline void sparse_set_index<T>::release_slot(uint64_t id) noexcept
+{
+    if (id > max_id) [[unlikely]]
+    {
+        _overflow.erase(id);
+        return;
+    }
+
+    auto& p = _pages[id >> page_bits];
+    p->slots[id & page_mask] = npos;
+
+    if (--p->used == 0)
+    {
+        _free_pages.push_back(std::move(p));
+    }
+}
@@ -1,19 +1,24 @@
 #pragma once
 
 #include "storage/storage.hpp"
+#include "storage/uninitialized_buffer.hpp"
 
 #include <range/v3/view/concat.hpp>
-#include <range/v3/view/slice.hpp>
+#include <range/v3/view/counted.hpp>
 #include <range/v3/view/transform.hpp>
 
+#include <algorithm>
 #include <array>
+#include <functional>
+#include <memory>
+#include <span>
 #include <vector>
 
 
 template <pool_item_derived T, uint32_t N>
 class static_growable_storage
 {
-    template <template <typename, uint32_t> typename storage, typename D, uint32_t M>
+    template <template <typename, uint32_t> typename storage, typename D, uint32_t M, template <typename> typename I>
     friend class orchestrator;
     
 public:
@@ -26,15 +31,22 @@ public:
     static_growable_storage() noexcept;
     ~static_growable_storage() noexcept;
 
-    static_growable_storage(static_growable_storage&& other) noexcept = default;
-    static_growable_storage& operator=(static_growable_storage&& other) noexcept = default;
+    static_growable_storage(static_growable_storage&& other) noexcept;
+    static_growable_storage& operator=(static_growable_storage&& other) noexcept;
 
     template <typename... Args>
     T* push(Args&&... args) noexcept;
     T* push_ptr(T* object) noexcept;
 
+    template <typename... Args>
+    void push_n(std::span<T*> out, std::span<const uint64_t> ids, const Args&... args) noexcept;
+
     template <typename... Args>
     void pop(T* obj, Args&&... args) noexcept;
+    void pop_n(std::span<T*> objs) noexcept;
+
+    // Makes room for `count` more elements at once
+    void reserve(uint32_t count) noexcept;
 
     void clear() noexcept;
     
@@ -42,11 +54,22 @@ public:
     {
         return ranges::views::transform(
             ranges::views::concat(
-                ranges::views::slice(_data, static_cast<uint16_t>(0), static_cast<std::size_t>(_current - &_data[0])),
+                ranges::views::counted(_data.data(), static_cast<std::size_t>(_current - _data.data())),
                 _growable),
             [](T& obj) { return &obj; });
     }
 
+    inline auto spans() noexcept
+    {
+        return std::array<std::span<T>, 2> {
+            std::span<T>(_data.data(), _current),
+            std::span<T>(_growable)
+        };
+    }
+
+    inline uint32_t index(T* obj) const noexcept;
+    inline T* at(uint32_t idx) noexcept;
+
     inline uint32_t size() const noexcept;
     inline bool empty() const noexcept;
     inline bool full() const noexcept;
@@ -57,7 +80,7 @@ private:
     bool is_static_full() const noexcept;
 
 private:
-    std::array<T, N> _data;
+    uninitialized_buffer<T, N> _data;
     T* _current;
     std::vector<T> _growable;
 };
@@ -66,12 +89,29 @@ private:
 template <pool_item_derived T, uint32_t N>
 static_growable_storage<T, N>::static_growable_storage() noexcept :
     _data(),
-    _current(&_data[0]),
+    _current(_data.data()),
     _growable()
 {
     _growable.reserve(N);
 }
 
+template <pool_item_derived T, uint32_t N>
+static_growable_storage<T, N>::static_growable_storage(static_growable_storage&& other) noexcept :
+    _data(std::move(other._data)),
+    _current(std::exchange(other._current, nullptr)),
+    _growable(std::move(other._growable))
+{}
+
+template <pool_item_derived T, uint32_t N>
+static_growable_storage<T, N>& static_growable_storage<T, N>::operator=(static_growable_storage&& other) noexcept
+{
+    clear();
+    _data = std::move(other._data);
+    std::swap(_current, other._current);
+    std::swap(_growable, other._growable);
+    return *this;
+}
+
 template <pool_item_derived T, uint32_t N>
 static_growable_storage<T, N>::~static_growable_storage() noexcept
 {
@@ -81,13 +121,13 @@ static_growable_storage<T, N>::~static_growable_storage() noexcept
 template <pool_item_derived T, uint32_t N>
 bool static_growable_storage<T, N>::is_static(T* obj) const noexcept
 {
-    return obj < &_data[0] + N;
+    return obj >= _data.data() && obj < _data.end();
 }
 
 template <pool_item_derived T, uint32_t N>
 bool static_growable_storage<T, N>::is_static_full() const noexcept
 {
-    return _current == &_data[0] + N;
+    return _current == _data.end();
 }
 
 template <pool_item_derived T, uint32_t N>
@@ -97,8 +137,8 @@ T* static_growable_storage<T, N>::push(Args&&... args) noexcept
     T* obj = _current;
     if (!is_static_full())
     {
-        assert(_current < &_data[0] + N && "Writing out of bounds");
-        ++_current;
+        assert(_current < _data.end() && "Writing out of bounds");
+        new (_current++) T();
     }
     else
     {
@@ -116,9 +156,8 @@ T* static_growable_storage<T, N>::push_ptr(T* object) noexcept
     T* obj = _current;
     if (!is_static_full())
     {
-        assert(_current < &_data[0] + N && "Writing out of bounds");
-        ++_current;
-        *obj = std::move(*object);
+        assert(_current < _data.end() && "Writing out of bounds");
+        new (_current++) T(std::move(*object));
     }
     else
     {
@@ -128,6 +167,32 @@ T* static_growable_storage<T, N>::push_ptr(T* object) noexcept
     return obj;
 }
 
+template <pool_item_derived T, uint32_t N>
+template <typename... Args>
+void static_growable_storage<T, N>::push_n(std::span<T*> out, std::span<const uint64_t> ids, const Args&... args) noexcept
+{
+    assert(out.size() == ids.size() && "Output and ids sizes do not match");
+
+    std::size_t idx = 0;
+    for (; idx < ids.size() && !is_static_full(); ++idx)
+    {
+        out[idx] = new (_current++) T();
+    }
+
+    const auto first = _growable.size();
+    _growable.resize(first + ids.size() - idx);
+    for (auto slot = first; idx < ids.size(); ++idx, ++slot)
+    {
+        out[idx] = &_growable[slot];
+    }
+
+    base_t::recreate_tickets(out);
+    for (std::size_t idx = 0; idx < ids.size(); ++idx)
+    {
+        static_cast<base_t&>(*out[idx]).base_construct(ids[idx], args...);
+    }
+}
+
 template <pool_item_derived T, uint32_t N>
 template <typename... Args>
 void static_growable_storage<T, N>::pop(T* obj, Args&&... args) noexcept
@@ -137,18 +202,33 @@ void static_growable_storage<T, N>::pop(T* obj, Args&&... args) noexcept
     release(obj);
 }
 
+template <pool_item_derived T, uint32_t N>
+void static_growable_storage<T, N>::pop_n(std::span<T*> objs) noexcept
+{
+    // From the highest index down, releasing an element never moves another one still to be popped
+    std::sort(objs.begin(), objs.end(), [this](T* a, T* b) { return index(a) > index(b); });
+    for (T* obj : objs)
+    {
+        pop(obj);
+    }
+}
+
 template <pool_item_derived T, uint32_t N>
 void static_growable_storage<T, N>::release(T* obj) noexcept
 {
-    assert(((obj >= &_data[0] && obj < _current) || (obj >= &_growable[0] && obj < &_growable[0] + _growable.size())) 
+    assert(((obj >= _data.data() && obj < _current) || (obj >= &_growable[0] && obj < &_growable[0] + _growable.size())) 
         && "Attempting to release an object from another storage");
 
-    if (is_static(obj))
+    // Always fill the hole with the last element, so that the static part has no gaps while the
+    //  growable one is in use, and pushes keep appending at the end of `range`
+    if (is_static(obj) && _growable.empty())
     {
         if (auto candidate = --_current; obj != candidate)
         {
             *obj = std::move(*candidate);
         }
+
+        std::destroy_at(_current);
     }
     else
     {
@@ -161,6 +241,17 @@ void static_growable_storage<T, N>::release(T* obj) noexcept
     }
 }
 
+template <pool_item_derived T, uint32_t N>
+void static_growable_storage<T, N>::reserve(uint32_t count) noexcept
+{
+    // Only the overflow vector ever reallocates
+    const auto room = static_cast<std::size_t>(_data.data() + N - _current);
+    if (auto needed = _growable.size() + count - std::min<std::size_t>(count, room); needed > _growable.capacity())
+    {
+        _growable.reserve(std::max(needed, _growable.capacity() * 2));
+    }
+}
+
 template <pool_item_derived T, uint32_t N>
 void static_growable_storage<T, N>::clear() noexcept
 {
@@ -169,15 +260,38 @@ void static_growable_storage<T, N>::clear() noexcept
         static_cast<base_t&>(*obj).base_destroy();
         static_cast<base_t&>(*obj).invalidate_ticket();
     }
-    
-    _current = &_data[0];
+
+    std::destroy(_data.data(), _current);
+    _current = _data.data();
     _growable.clear();
 }
 
+template <pool_item_derived T, uint32_t N>
+inline uint32_t static_growable_storage<T, N>::index(T* obj) const noexcept
+{
+    if (is_static(obj))
+    {
+        return static_cast<uint32_t>(obj - _data.data());
+    }
+
+    return static_cast<uint32_t>(_current - _data.data() + (obj - _growable.data()));
+}
+
+template <pool_item_derived T, uint32_t N>
+inline T* static_growable_storage<T, N>::at(uint32_t idx) noexcept
+{
+    if (auto fixed = static_cast<uint32_t>(_current - _data.data()); idx >= fixed)
+    {
+        return &_growable[idx - fixed];
+    }
+
+    return _data.data() + idx;
+}
+
 template <pool_item_derived T, uint32_t N>
 inline uint32_t static_growable_storage<T, N>::size() const noexcept
 {
-    return _current - &_data[0] + _growable.size();
+    return _current - _data.data() + _growable.size();
 }
 
 template <pool_item_derived T, uint32_t N>
@@ -1,17 +1,22 @@
 #pragma once
 
 #include "storage/storage.hpp"
+#include "storage/uninitialized_buffer.hpp"
 
-#include <range/v3/view/slice.hpp>
+#include <range/v3/view/counted.hpp>
 #include <range/v3/view/transform.hpp>
 
+#include <algorithm>
 #include <array>
+#include <functional>
+#include <memory>
+#include <span>
 
 
 template <pool_item_derived T, uint32_t N>
 class static_storage
 {
-    template <template <typename, uint32_t> typename storage, typename D, uint32_t M>
+    template <template <typename, uint32_t> typename storage, typename D, uint32_t M, template <typename> typename I>
     friend class orchestrator;
     
 public:
@@ -24,25 +29,40 @@ public:
     static_storage() noexcept;
     ~static_storage() noexcept;
 
-    static_storage(static_storage&& other) noexcept = default;
-    static_storage& operator=(static_storage&& other) noexcept = default;
+    static_storage(static_storage&& other) noexcept;
+    static_storage& operator=(static_storage&& other) noexcept;
 
     template <typename... Args>
     T* push(Args&&... args) noexcept;
     T* push_ptr(T* object) noexcept;
 
+    template <typename... Args>
+    void push_n(std::span<T*> out, std::span<const uint64_t> ids, const Args&... args) noexcept;
+
     template <typename... Args>
     void pop(T* obj, Args&&... args) noexcept;
+    void pop_n(std::span<T*> objs) noexcept;
+
+    // Makes room for `count` more elements at once
+    void reserve(uint32_t count) noexcept;
 
     void clear() noexcept;
     
     inline auto range() noexcept
     {
         return ranges::views::transform(
-            ranges::views::slice(_data, static_cast<uint16_t>(0), static_cast<std::size_t>(_current - &_data[0])),
+            ranges::views::counted(_data.data(), size()),
             [](T& obj) { return &obj; });
     }
 
+    inline auto spans() noexcept
+    {
+        return std::array<std::span<T>, 1> { std::span<T>(_data.data(), size()) };
+    }
+
+    inline uint32_t index(T* obj) const noexcept;
+    inline T* at(uint32_t idx) noexcept;
+
     inline uint32_t size() const noexcept;
     inline bool empty() const noexcept;
     inline bool full() const noexcept;
@@ -51,7 +71,7 @@ private:
     void release(T* obj) noexcept;
 
 private:
-    std::array<T, N> _data;
+    uninitialized_buffer<T, N> _data;
     T* _current;
 };
 
@@ -59,9 +79,24 @@ private:
 template <pool_item_derived T, uint32_t N>
 static_storage<T, N>::static_storage() noexcept :
     _data(),
-    _current(&_data[0])
+    _current(_data.data())
 {}
 
+template <pool_item_derived T, uint32_t N>
+static_storage<T, N>::static_storage(static_storage&& other) noexcept :
+    _data(std::move(other._data)),
+    _current(std::exchange(other._current, nullptr))
+{}
+
+template <pool_item_derived T, uint32_t N>
+static_storage<T, N>& static_storage<T, N>::operator=(static_storage&& other) noexcept
+{
+    clear();
+    _data = std::move(other._data);
+    std::swap(_current, other._current);
+    return *this;
+}
+
 
 template <pool_item_derived T, uint32_t N>
 static_storage<T, N>::~static_storage() noexcept
@@ -73,7 +108,8 @@ template <pool_item_derived T, uint32_t N>
 template <typename... Args>
 T* static_storage<T, N>::push(Args&&... args) noexcept
 {
-    assert(_current < &_data[0] + N && "Writing out of bounds");
+    assert(_current < _data.end() && "Writing out of bounds");
+    new (_current) T();
     static_cast<base_t&>(*_current).recreate_ticket();
     static_cast<base_t&>(*_current).base_construct(std::forward<Args>(args)...);
     return _current++;
@@ -82,11 +118,30 @@ T* static_storage<T, N>::push(Args&&... args) noexcept
 template <pool_item_derived T, uint32_t N>
 T* static_storage<T, N>::push_ptr(T* object) noexcept
 {
-    assert(_current < &_data[0] + N && "Writing out of bounds");
-    *_current = std::move(*object);
+    assert(_current < _data.end() && "Writing out of bounds");
+    new (_current) T(std::move(*object));
     return _current++;
 }
 
+template <pool_item_derived T, uint32_t N>
+template <typename... Args>
+void static_storage<T, N>::push_n(std::span<T*> out, std::span<const uint64_t> ids, const Args&... args) noexcept
+{
+    assert(out.size() == ids.size() && "Output and ids sizes do not match");
+    assert(_current + ids.size() <= _data.end() && "Writing out of bounds");
+
+    for (std::size_t idx = 0; idx < ids.size(); ++idx)
+    {
+        out[idx] = new (_current++) T();
+    }
+
+    base_t::recreate_tickets(out);
+    for (std::size_t idx = 0; idx < ids.size(); ++idx)
+    {
+        static_cast<base_t&>(*out[idx]).base_construct(ids[idx], args...);
+    }
+}
+
 template <pool_item_derived T, uint32_t N>
 template <typename... Args>
 void static_storage<T, N>::pop(T* obj, Args&&... args) noexcept
@@ -96,15 +151,34 @@ void static_storage<T, N>::pop(T* obj, Args&&... args) noexcept
     release(obj);
 }
 
+template <pool_item_derived T, uint32_t N>
+void static_storage<T, N>::pop_n(std::span<T*> objs) noexcept
+{
+    // From the highest index down, releasing an element never moves another one still to be popped
+    std::sort(objs.begin(), objs.end(), std::greater<T*>());
+    for (T* obj : objs)
+    {
+        pop(obj);
+    }
+}
+
 template <pool_item_derived T, uint32_t N>
 void static_storage<T, N>::release(T* obj) noexcept
 {
-    assert(obj >= &_data[0] && obj < _current && "Attempting to release an object from another storage");
+    assert(obj >= _data.data() && obj < _current && "Attempting to release an object from another storage");
 
     if (auto candidate = --_current; obj != candidate)
     {
         *obj = std::move(*candidate);
     }
+
+    std::destroy_at(_current);
+}
+
+template <pool_item_derived T, uint32_t N>
+void static_storage<T, N>::reserve(uint32_t count) noexcept
+{
+    // Fixed capacity, elements never move
 }
 
 template <pool_item_derived T, uint32_t N>
@@ -114,15 +188,28 @@ void static_storage<T, N>::clear() noexcept
     {
         static_cast<base_t&>(*obj).base_destroy();
         static_cast<base_t&>(*obj).invalidate_ticket();
+        std::destroy_at(obj);
     }
 
-    _current = &_data[0];
+    _current = _data.data();
+}
+
+template <pool_item_derived T, uint32_t N>
+inline uint32_t static_storage<T, N>::index(T* obj) const noexcept
+{
+    return static_cast<uint32_t>(obj - _data.data());
+}
+
+template <pool_item_derived T, uint32_t N>
+inline T* static_storage<T, N>::at(uint32_t idx) noexcept
+{
+    return _data.data() + idx;
 }
 
 template <pool_item_derived T, uint32_t N>
 inline uint32_t static_storage<T, N>::size() const noexcept
 {
-    return _current - &_data[0];
+    return _current - _data.data();
 }
 
 template <pool_item_derived T, uint32_t N>
@@ -134,5 +221,5 @@ inline bool static_storage<T, N>::empty() const noexcept
 template <pool_item_derived T, uint32_t N>
 inline bool static_storage<T, N>::full() const noexcept
 {
-    return _current == &_data[0] + N;
+    return _current == _data.end();
 }
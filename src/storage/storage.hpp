@@ -1,10 +1,16 @@
 #pragma once
 
+#include "storage/map_index.hpp"
 #include "storage/pool_item.hpp"
 
 #include <spdlog/spdlog.h>
+#include <algorithm>
 #include <atomic>
+#include <functional>
 #include <inttypes.h>
+#include <span>
+#include <utility>
+#include <vector>
 
 
 template <typename T>
@@ -26,7 +32,9 @@ enum class storage_layout : uint8_t
 {
     none            = 0,
     continuous      = 1,
-    partitioned     = 2
+    partitioned     = 2,
+    soa             = 4,
+    multi_partitioned = 8
 };
 
 inline constexpr uint8_t storage_tag(storage_grow grow, storage_layout layout) noexcept
@@ -44,18 +52,32 @@ inline constexpr bool is_partitioned_storage(uint8_t tag) noexcept
     return has_storage_tag(tag, storage_grow::none, storage_layout::partitioned);
 }
 
-template <template <typename, uint32_t> typename storage, typename T, uint32_t N>
+inline constexpr bool is_multi_partitioned_storage(uint8_t tag) noexcept
+{
+    return has_storage_tag(tag, storage_grow::none, storage_layout::multi_partitioned);
+}
+
+inline constexpr bool is_soa_storage(uint8_t tag) noexcept
+{
+    return has_storage_tag(tag, storage_grow::none, storage_layout::soa);
+}
+
+template <template <typename, uint32_t> typename storage, typename T, uint32_t N, template <typename> typename index = map_index>
 class orchestrator
 {
-    template <template <typename, uint32_t> typename S, typename D, uint32_t M>
+    template <template <typename, uint32_t> typename S, typename D, uint32_t M, template <typename> typename I>
     friend class orchestrator;
 
+    template <typename... comps>
+    friend class owning_group;
+
 public:
     static constexpr inline uint8_t tag = storage<T, N>::tag;
 
     using base_t = typename storage<T, N>::base_t;
     using derived_t = typename storage<T, N>::derived_t;
-    using orchestrator_t = orchestrator<storage, T, N>;
+    using orchestrator_t = orchestrator<storage, T, N, index>;
+    using index_t = index<T>;
     
     orchestrator() noexcept;
 
@@ -64,14 +86,30 @@ public:
 
     T* get(uint64_t id) const noexcept;
 
+    // Start the index loads of `get(id)` ahead of it, see the index policies
+    void prefetch(uint64_t id) const noexcept;
+    void prefetch_entry(uint64_t id) const noexcept;
+
     template <typename... Args>
     T* push(Args&&... args) noexcept;
     void pop(T* obj) noexcept;
 
+    // Batched push and pop. `args` are given to the storage as `[predicate,] ids, constructor args...`,
+    //  and `out` receives one element per id, in the same order. `objs` doubles as scratch space, so that
+    //  popping does not allocate: it is sorted in place and, for grouped storages, its pointers are rewritten
+    //  as elements leave the group. Its contents are unspecified afterwards
+    template <typename... Args>
+    void push_n(std::span<T*> out, Args&&... args) noexcept;
+    void pop_n(std::span<T*> objs) noexcept;
+
     void clear() noexcept;
     
-    template <template <typename, uint32_t> typename S, uint32_t M, typename... Args>
-    T* move(orchestrator<S, T, M>& other, T* obj, Args... args) noexcept;
+    template <template <typename, uint32_t> typename S, uint32_t M, template <typename> typename I, typename... Args>
+    T* move(orchestrator<S, T, M, I>& other, T* obj, Args... args) noexcept;
+
+    // Moves all of `objs`, which are updated in place to their new addresses
+    template <template <typename, uint32_t> typename S, uint32_t M, template <typename> typename I, typename... Args>
+    void move_n(orchestrator<S, T, M, I>& other, std::span<T*> objs, Args... args) noexcept;
 
     [[deprecated]]
     inline auto unsafe_range() noexcept
@@ -105,6 +143,48 @@ public:
         return _storage.range_from_partition();
     }
 
+    // Contiguous blocks covering the same elements as `range`, in the same order
+    inline auto spans() noexcept
+    {
+#if !defined(NDEBUG)
+        _is_write_locked = true;
+#endif
+        return _storage.spans();
+    }
+
+    template <typename D = storage<T, N>, typename = std::enable_if_t<has_storage_tag(D::tag, storage_grow::none, storage_layout::partitioned)>>
+    inline auto spans_until_partition() noexcept
+    {
+#if !defined(NDEBUG)
+        _is_write_locked = true;
+#endif
+        return _storage.spans_until_partition();
+    }
+
+    template <typename D = storage<T, N>, typename = std::enable_if_t<has_storage_tag(D::tag, storage_grow::none, storage_layout::partitioned)>>
+    inline auto spans_from_partition() noexcept
+    {
+#if !defined(NDEBUG)
+        _is_write_locked = true;
+#endif
+        return _storage.spans_from_partition();
+    }
+
+    template <std::size_t I, typename D = storage<T, N>, typename = std::enable_if_t<is_soa_storage(D::tag)>>
+    inline auto field() noexcept
+    {
+#if !defined(NDEBUG)
+        _is_write_locked = true;
+#endif
+        return _storage.template field<I>();
+    }
+
+    template <std::size_t I, typename D = storage<T, N>, typename = std::enable_if_t<is_soa_storage(D::tag)>>
+    inline auto& field(T* obj) noexcept
+    {
+        return _storage.template field<I>(obj);
+    }
+
 #if !defined(NDEBUG)
     inline void unlock_writes()
     {
@@ -124,6 +204,11 @@ public:
         return _storage.change_partition(predicate, obj);
     }
 
+    // Moves every element of `objs` to the other partition, which are updated in place to their new addresses.
+    //  Elements crossing in opposite directions swap places, thus each costs a single swap
+    template <typename D = storage<T, N>, typename = std::enable_if_t<has_storage_tag(D::tag, storage_grow::none, storage_layout::partitioned)>>
+    void change_partition_n(std::span<T*> objs) noexcept;
+
     template <typename D = storage<T, N>, typename = std::enable_if_t<has_storage_tag(D::tag, storage_grow::none, storage_layout::partitioned)>>
     inline uint32_t size_until_partition() const noexcept;
     
@@ -136,41 +221,99 @@ public:
 
     inline storage<T, N>& raw_storage() noexcept;
 
+    template <typename D = storage<T, N>, typename = std::enable_if_t<is_multi_partitioned_storage(D::tag)>>
+    inline auto range(uint8_t partition) noexcept
+    {
+#if !defined(NDEBUG)
+        _is_write_locked = true;
+#endif
+        return _storage.range(partition);
+    }
+
+    template <typename D = storage<T, N>, typename = std::enable_if_t<is_multi_partitioned_storage(D::tag)>>
+    inline auto spans(uint8_t partition) noexcept
+    {
+#if !defined(NDEBUG)
+        _is_write_locked = true;
+#endif
+        return _storage.spans(partition);
+    }
+
+    template <typename D = storage<T, N>, typename = std::enable_if_t<is_multi_partitioned_storage(D::tag)>>
+    inline auto change_partition(uint8_t partition, T* obj) noexcept
+    {
+#if !defined(NDEBUG)
+        assert(!_is_write_locked && "Attempting to change partition while iterating");
+#endif
+#if defined(UMI_ENABLE_DEBUG_LOGS)
+        spdlog::trace("ORCHESTRATOR CHANGE PARTITION");
+#endif
+        return _storage.change_partition(partition, obj);
+    }
+
+    template <typename D = storage<T, N>, typename = std::enable_if_t<is_multi_partitioned_storage(D::tag)>>
+    inline uint32_t size(uint8_t partition) const noexcept
+    {
+        return _storage.size(partition);
+    }
+
 private:
-    std::unordered_map<uint64_t, typename ::ticket<component<typename T::derived_t>>::ptr> _tickets;
+    template <template <typename, uint32_t> typename S, uint32_t M, template <typename> typename I, typename... Args>
+    T* transfer(orchestrator<S, T, M, I>& other, T* obj, Args... args) noexcept;
+
+    inline void group_join(T* obj) noexcept;
+    inline T* group_leave(T* obj) noexcept;
+    inline void swap(T* a, T* b) noexcept;
+
+private:
+    index_t _index;
     storage<T, N> _storage;
 
+    // While owned by an `owning_group`, the first `_group_size` elements are kept in the same order
+    //  in all of its members, and the group is told about every id pushed to its first member
+    bool _is_grouped;
+    uint32_t _group_size;
+    std::vector<uint64_t>* _group_joins;
+
 #if !defined(NDEBUG)
     bool _is_write_locked;
 #endif
 };
 
-template <template <typename, uint32_t> typename storage, typename T, uint32_t N>
-orchestrator<storage, T, N>::orchestrator() noexcept :
-    _tickets(),
-    _storage()
+template <template <typename, uint32_t> typename storage, typename T, uint32_t N, template <typename> typename index>
+orchestrator<storage, T, N, index>::orchestrator() noexcept :
+    _index(N),
+    _storage(),
+    _is_grouped(false),
+    _group_size(0),
+    _group_joins(nullptr)
 {
 #if !defined(NDEBUG)
     _is_write_locked = false;
 #endif
 }
 
-template <template <typename, uint32_t> typename storage, typename T, uint32_t N>
-T* orchestrator<storage, T, N>::get(uint64_t id) const noexcept
+template <template <typename, uint32_t> typename storage, typename T, uint32_t N, template <typename> typename index>
+T* orchestrator<storage, T, N, index>::get(uint64_t id) const noexcept
 {
-    if (auto it = _tickets.find(id); it != _tickets.end())
-    {
-        // TODO(gpascualg): Why would a ticket inside here be invalid?
-	assert(it->second->valid() && "Orchestrator has an invalid ticket");
-        return it->second->get()->derived();
-    }
+    return _index.get(id);
+}
 
-    return nullptr;
+template <template <typename, uint32_t> typename storage, typename T, uint32_t N, template <typename> typename index>
+void orchestrator<storage, T, N, index>::prefetch(uint64_t id) const noexcept
+{
+    _index.prefetch(id);
+}
+
+template <template <typename, uint32_t> typename storage, typename T, uint32_t N, template <typename> typename index>
+void orchestrator<storage, T, N, index>::prefetch_entry(uint64_t id) const noexcept
+{
+    _index.prefetch_entry(id);
 }
 
-template <template <typename, uint32_t> typename storage, typename T, uint32_t N>
+template <template <typename, uint32_t> typename storage, typename T, uint32_t N, template <typename> typename index>
 template <typename... Args>
-T* orchestrator<storage, T, N>::push(Args&&... args) noexcept
+T* orchestrator<storage, T, N, index>::push(Args&&... args) noexcept
 {
 #if !defined(NDEBUG)
     assert(!_is_write_locked && "Attempting to push while iterating");
@@ -180,12 +323,18 @@ T* orchestrator<storage, T, N>::push(Args&&... args) noexcept
 #endif
 
     T* obj = _storage.push(std::forward<Args>(args)...);
-    _tickets.emplace(obj->id(), obj->ticket());
+    _index.insert(obj);
+
+    if (_group_joins)
+    {
+        _group_joins->push_back(obj->id());
+    }
+
     return obj;
 }
 
-template <template <typename, uint32_t> typename storage, typename T, uint32_t N>
-void orchestrator<storage, T, N>::pop(T* obj) noexcept
+template <template <typename, uint32_t> typename storage, typename T, uint32_t N, template <typename> typename index>
+void orchestrator<storage, T, N, index>::pop(T* obj) noexcept
 {
 #if !defined(NDEBUG)
     assert(!_is_write_locked && "Attempting to pop while iterating");
@@ -194,12 +343,72 @@ void orchestrator<storage, T, N>::pop(T* obj) noexcept
     spdlog::trace("ORCHESTRATOR POP");
 #endif
 
-    _tickets.erase(obj->id());
+    obj = group_leave(obj);
+    _index.erase(obj->id());
     _storage.pop(obj);
 }
 
-template <template <typename, uint32_t> typename storage, typename T, uint32_t N>
-void orchestrator<storage, T, N>::clear() noexcept
+template <template <typename, uint32_t> typename storage, typename T, uint32_t N, template <typename> typename index>
+template <typename... Args>
+void orchestrator<storage, T, N, index>::push_n(std::span<T*> out, Args&&... args) noexcept
+{
+#if !defined(NDEBUG)
+    assert(!_is_write_locked && "Attempting to push while iterating");
+#endif
+#if defined(UMI_ENABLE_DEBUG_LOGS)
+    spdlog::trace("ORCHESTRATOR PUSH N");
+#endif
+
+    _index.reserve(static_cast<uint32_t>(out.size()));
+    _storage.push_n(out, std::forward<Args>(args)...);
+
+    for (T* obj : out)
+    {
+        _index.insert(obj);
+    }
+
+    if (_group_joins)
+    {
+        for (T* obj : out)
+        {
+            _group_joins->push_back(obj->id());
+        }
+    }
+}
+
+template <template <typename, uint32_t> typename storage, typename T, uint32_t N, template <typename> typename index>
+void orchestrator<storage, T, N, index>::pop_n(std::span<T*> objs) noexcept
+{
+#if !defined(NDEBUG)
+    assert(!_is_write_locked && "Attempting to pop while iterating");
+#endif
+#if defined(UMI_ENABLE_DEBUG_LOGS)
+    spdlog::trace("ORCHESTRATOR POP N");
+#endif
+
+    if constexpr (!is_partitioned_storage(tag) && !is_multi_partitioned_storage(tag))
+    {
+        if (_is_grouped)
+        {
+            // Leaving from the highest index down only ever swaps in elements that stay
+            std::sort(objs.begin(), objs.end(), [this](T* a, T* b) { return _storage.index(a) > _storage.index(b); });
+            for (T*& obj : objs)
+            {
+                obj = group_leave(obj);
+            }
+        }
+    }
+
+    for (T* obj : objs)
+    {
+        _index.erase(obj->id());
+    }
+
+    _storage.pop_n(objs);
+}
+
+template <template <typename, uint32_t> typename storage, typename T, uint32_t N, template <typename> typename index>
+void orchestrator<storage, T, N, index>::clear() noexcept
 {
 #if !defined(NDEBUG)
     assert(!_is_write_locked && "Attempting to clear while iterating");
@@ -208,21 +417,84 @@ void orchestrator<storage, T, N>::clear() noexcept
     spdlog::trace("ORCHESTRATOR CLEAR");
 #endif
 
-    _tickets.clear();
+    _index.clear();
     _storage.clear();
+    _group_size = 0;
 }
 
-template <template <typename, uint32_t> typename storage, typename T, uint32_t N>
-template <template <typename, uint32_t> typename S, uint32_t M, typename... Args>
-T* orchestrator<storage, T, N>::move(orchestrator<S, T, M>& other, T* obj, Args... args) noexcept
+template <template <typename, uint32_t> typename storage, typename T, uint32_t N, template <typename> typename index>
+template <template <typename, uint32_t> typename S, uint32_t M, template <typename> typename I, typename... Args>
+T* orchestrator<storage, T, N, index>::move(orchestrator<S, T, M, I>& other, T* obj, Args... args) noexcept
 {
 #if defined(UMI_ENABLE_DEBUG_LOGS)
     spdlog::trace("ORCHESTRATOR MOVE");
 #endif
 
+    obj = group_leave(obj);
+
     // Change vectors
+    T* new_ptr = transfer(other, obj, args...);
+
+    // Add to dicts
+    _index.erase(new_ptr->id());
+    other._index.insert(new_ptr);
+
+    if (other._group_joins)
+    {
+        other._group_joins->push_back(new_ptr->id());
+    }
+
+    return new_ptr;
+}
+
+template <template <typename, uint32_t> typename storage, typename T, uint32_t N, template <typename> typename index>
+template <template <typename, uint32_t> typename S, uint32_t M, template <typename> typename I, typename... Args>
+void orchestrator<storage, T, N, index>::move_n(orchestrator<S, T, M, I>& other, std::span<T*> objs, Args... args) noexcept
+{
+#if defined(UMI_ENABLE_DEBUG_LOGS)
+    spdlog::trace("ORCHESTRATOR MOVE N");
+#endif
+
+    // From the highest index down, neither leaving the group nor releasing ever displaces an element
+    //  that is still to be moved, thus the source is compacted in a single pass
+    std::vector<std::pair<uint32_t, uint32_t>> order(objs.size());
+    std::vector<uint64_t> ids(objs.size());
+    for (uint32_t idx = 0; idx < objs.size(); ++idx)
+    {
+        order[idx] = { _storage.index(objs[idx]), idx };
+        ids[idx] = objs[idx]->id();
+    }
+
+    std::sort(order.begin(), order.end(), std::greater<>());
+
+    other.raw_storage().reserve(static_cast<uint32_t>(objs.size()));
+    other._index.reserve(static_cast<uint32_t>(objs.size()));
+    for (auto [position, idx] : order)
+    {
+        T* new_ptr = transfer(other, group_leave(objs[idx]), args...);
+        _index.erase(new_ptr->id());
+        other._index.insert(new_ptr);
+    }
+
+    // Partitioned destinations swap earlier arrivals around, and growable ones may still reallocate,
+    //  thus pointers are only resolved once every element has landed
+    for (uint32_t idx = 0; idx < objs.size(); ++idx)
+    {
+        objs[idx] = other.get(ids[idx]);
+    }
+
+    if (other._group_joins)
+    {
+        other._group_joins->insert(other._group_joins->end(), ids.begin(), ids.end());
+    }
+}
+
+template <template <typename, uint32_t> typename storage, typename T, uint32_t N, template <typename> typename index>
+template <template <typename, uint32_t> typename S, uint32_t M, template <typename> typename I, typename... Args>
+T* orchestrator<storage, T, N, index>::transfer(orchestrator<S, T, M, I>& other, T* obj, Args... args) noexcept
+{
     T* new_ptr = nullptr;
-    if constexpr (has_storage_tag(orchestrator<S, T, M>::tag, storage_grow::none, storage_layout::partitioned))
+    if constexpr (has_storage_tag(orchestrator<S, T, M, I>::tag, storage_grow::none, storage_layout::partitioned))
     {
         if constexpr (has_storage_tag(tag, storage_grow::none, storage_layout::partitioned))
         {
@@ -240,52 +512,165 @@ T* orchestrator<storage, T, N>::move(orchestrator<S, T, M>& other, T* obj, Args.
             raw_storage().release(obj);
         }
     }
+    else if constexpr (is_multi_partitioned_storage(orchestrator<S, T, M, I>::tag))
+    {
+        if constexpr (is_multi_partitioned_storage(tag))
+        {
+            new_ptr = other.raw_storage().push_ptr(_storage.partition(obj), obj);
+            raw_storage().release(obj);
+        }
+        else
+        {
+            static_assert(sizeof...(Args) == 1, "Must provide the destination partition when moving to a multi-partitioned storage");
+            new_ptr = other.raw_storage().push_ptr(static_cast<uint8_t>(std::get<0>(std::forward_as_tuple(args...))), obj);
+            raw_storage().release(obj);
+        }
+    }
+    else if constexpr (is_soa_storage(tag) && is_soa_storage(orchestrator<S, T, M, I>::tag))
+    {
+        // Carry the fields along, otherwise they would be reset
+        new_ptr = other.raw_storage().push_ptr(obj, _storage.fields(obj));
+        raw_storage().release(obj);
+    }
     else
     {
         new_ptr = other.raw_storage().push_ptr(obj);
         raw_storage().release(obj);
     }
 
-    // Add to dicts
-    _tickets.erase(new_ptr->id());
-    other._tickets.emplace(new_ptr->id(), new_ptr->ticket());
     return new_ptr;
 }
 
-template <template <typename, uint32_t> typename storage, typename T, uint32_t N>
-inline uint32_t orchestrator<storage, T, N>::size() const noexcept
+template <template <typename, uint32_t> typename storage, typename T, uint32_t N, template <typename> typename index>
+template <typename D, typename>
+void orchestrator<storage, T, N, index>::change_partition_n(std::span<T*> objs) noexcept
+{
+#if !defined(NDEBUG)
+    assert(!_is_write_locked && "Attempting to change partition while iterating");
+#endif
+#if defined(UMI_ENABLE_DEBUG_LOGS)
+    spdlog::trace("ORCHESTRATOR CHANGE PARTITION N");
+#endif
+
+    // Positions in `objs`, pairs are taken from the elements farthest from the partition point
+    std::vector<uint32_t> to_false;
+    std::vector<uint32_t> to_true;
+    for (uint32_t idx = 0; idx < objs.size(); ++idx)
+    {
+        (_storage.partition(objs[idx]) ? to_false : to_true).push_back(idx);
+    }
+
+    std::sort(to_false.begin(), to_false.end(), [this, objs](uint32_t a, uint32_t b) { return _storage.index(objs[a]) < _storage.index(objs[b]); });
+    std::sort(to_true.begin(), to_true.end(), [this, objs](uint32_t a, uint32_t b) { return _storage.index(objs[a]) > _storage.index(objs[b]); });
+
+    const auto pairs = std::min(to_false.size(), to_true.size());
+    for (std::size_t idx = 0; idx < pairs; ++idx)
+    {
+        T* a = objs[to_false[idx]];
+        T* b = objs[to_true[idx]];
+        swap(a, b);
+
+        objs[to_false[idx]] = b;
+        objs[to_true[idx]] = a;
+    }
+
+    // The rest are the closest to the partition point, thus moving it never displaces another element of `objs`
+    for (auto it = to_false.rbegin(); it != to_false.rend() - pairs; ++it)
+    {
+        objs[*it] = _storage.change_partition(false, objs[*it]);
+    }
+
+    for (auto it = to_true.rbegin(); it != to_true.rend() - pairs; ++it)
+    {
+        objs[*it] = _storage.change_partition(true, objs[*it]);
+    }
+}
+
+template <template <typename, uint32_t> typename storage, typename T, uint32_t N, template <typename> typename index>
+inline uint32_t orchestrator<storage, T, N, index>::size() const noexcept
 {
     return _storage.size();
 }
 
-template <template <typename, uint32_t> typename storage, typename T, uint32_t N>
+template <template <typename, uint32_t> typename storage, typename T, uint32_t N, template <typename> typename index>
 template <typename D, typename>
-inline uint32_t orchestrator<storage, T, N>::size_until_partition() const noexcept
+inline uint32_t orchestrator<storage, T, N, index>::size_until_partition() const noexcept
 {
     return _storage.size_until_partition();
 }
 
-template <template <typename, uint32_t> typename storage, typename T, uint32_t N>
+template <template <typename, uint32_t> typename storage, typename T, uint32_t N, template <typename> typename index>
 template <typename D, typename>
-inline uint32_t orchestrator<storage, T, N>::size_from_partition() const noexcept
+inline uint32_t orchestrator<storage, T, N, index>::size_from_partition() const noexcept
 {
     return _storage.size_from_partition();
 }
 
-template <template <typename, uint32_t> typename storage, typename T, uint32_t N>
-inline bool orchestrator<storage, T, N>::empty() const noexcept
+template <template <typename, uint32_t> typename storage, typename T, uint32_t N, template <typename> typename index>
+inline bool orchestrator<storage, T, N, index>::empty() const noexcept
 {
     return _storage.empty();
 }
 
-template <template <typename, uint32_t> typename storage, typename T, uint32_t N>
-inline bool orchestrator<storage, T, N>::full() const noexcept
+template <template <typename, uint32_t> typename storage, typename T, uint32_t N, template <typename> typename index>
+inline bool orchestrator<storage, T, N, index>::full() const noexcept
 {
     return _storage.full();
 }
 
-template <template <typename, uint32_t> typename storage, typename T, uint32_t N>
-inline storage<T, N>& orchestrator<storage, T, N>::raw_storage() noexcept
+template <template <typename, uint32_t> typename storage, typename T, uint32_t N, template <typename> typename index>
+inline storage<T, N>& orchestrator<storage, T, N, index>::raw_storage() noexcept
 {
     return _storage;
 }
+
+template <template <typename, uint32_t> typename storage, typename T, uint32_t N, template <typename> typename index>
+inline void orchestrator<storage, T, N, index>::group_join(T* obj) noexcept
+{
+#if !defined(NDEBUG)
+    assert(!_is_write_locked && "Attempting to refresh a group while iterating");
+#endif
+
+    if (_storage.index(obj) >= _group_size)
+    {
+        if (T* slot = _storage.at(_group_size); slot != obj)
+        {
+            swap(slot, obj);
+        }
+
+        ++_group_size;
+    }
+}
+
+template <template <typename, uint32_t> typename storage, typename T, uint32_t N, template <typename> typename index>
+inline T* orchestrator<storage, T, N, index>::group_leave(T* obj) noexcept
+{
+    // Partitioned storages can't be owned, their order is given by the partition
+    if constexpr (!is_partitioned_storage(tag) && !is_multi_partitioned_storage(tag))
+    {
+        if (_is_grouped && _storage.index(obj) < _group_size)
+        {
+            // Swap it right past the owned elements, where popping it does not disturb them
+            if (T* last = _storage.at(--_group_size); last != obj)
+            {
+                swap(last, obj);
+                return last;
+            }
+        }
+    }
+
+    return obj;
+}
+
+template <template <typename, uint32_t> typename storage, typename T, uint32_t N, template <typename> typename index>
+inline void orchestrator<storage, T, N, index>::swap(T* a, T* b) noexcept
+{
+    if constexpr (is_soa_storage(tag))
+    {
+        _storage.swap(a, b);
+    }
+    else
+    {
+        std::swap(*a, *b);
+    }
+}
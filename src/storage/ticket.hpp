@@ -1,5 +1,7 @@
 #pragma once
 
+#include "storage/slot_table.hpp"
+
 #include <inttypes.h>
 #include <atomic>
 
@@ -15,6 +17,8 @@ class ticket
 {
     template <typename D, typename E, uint16_t I, typename R> friend class pooled_static_vector;
     template <typename D> friend class pool_item;
+    template <typename D> friend class slot_table;
+    template <typename D> friend class handle;
 
     template <typename D> friend void intrusive_ptr_add_ref(ticket<D>* x);
     template <typename D> friend void intrusive_ptr_release(ticket<D>* x);
@@ -22,8 +26,6 @@ class ticket
 public:
     using ptr = boost::intrusive_ptr<ticket<T>>;
 
-    ticket(T* ptr);
-
     inline auto get() const
     {
         return _ptr->derived();
@@ -37,11 +39,18 @@ public:
     inline bool valid() const;
 
 private:
+    ticket(T* ptr, uint32_t slot);
+
+    static inline ptr make(T* ptr);
     inline void invalidate();
 
 private:
     T* _ptr;
     std::atomic<uint32_t> _refs;
+    uint32_t _slot;
+    // Handles compare it from any thread while the owning storage pops, relaxed ordering is enough as
+    //  resolving a handle concurrently with its pop is a race on the component anyway
+    std::atomic<uint32_t> _generation;
 };
 
 template <typename T>
@@ -49,11 +58,19 @@ using ticket_of_t = typename ::ticket<component<T>>::ptr;
 
 
 template <typename T>
-ticket<T>::ticket(T* ptr) :
+ticket<T>::ticket(T* ptr, uint32_t slot) :
     _ptr(ptr),
-    _refs(0)
+    _refs(0),
+    _slot(slot),
+    _generation(0)
 {}
 
+template <typename T>
+inline typename ticket<T>::ptr ticket<T>::make(T* ptr)
+{
+    return ticket<T>::ptr(slot_table<T>::instance().acquire(ptr));
+}
+
 template <typename T>
 inline bool ticket<T>::valid() const
 {
@@ -64,6 +81,7 @@ template <typename T>
 inline void ticket<T>::invalidate()
 { 
     _ptr = nullptr;
+    _generation.fetch_add(1, std::memory_order_relaxed);
 }
 
 template <typename T>
@@ -83,6 +101,6 @@ inline void intrusive_ptr_release(ticket<T>* x)
 {
     if(--x->_refs == 0) 
     {
-        delete x;
+        slot_table<T>::instance().release(x);
     }
 }
@@ -0,0 +1,72 @@
+#pragma once
+
+#include <cstddef>
+#include <inttypes.h>
+#include <new>
+#include <utility>
+
+
+// Aligned but uninitialized memory for N objects. Owners construct and destroy elements on demand,
+// so untouched pages are never backed by physical memory and moving the buffer keeps pointers valid
+template <typename T, uint32_t N>
+class uninitialized_buffer
+{
+public:
+    uninitialized_buffer() noexcept;
+    ~uninitialized_buffer() noexcept;
+
+    uninitialized_buffer(uninitialized_buffer&& other) noexcept;
+    uninitialized_buffer& operator=(uninitialized_buffer&& other) noexcept;
+
+    inline T* data() const noexcept;
+    inline T* end() const noexcept;
+    inline T& operator[](std::size_t idx) const noexcept;
+
+private:
+    T* _data;
+};
+
+
+template <typename T, uint32_t N>
+uninitialized_buffer<T, N>::uninitialized_buffer() noexcept :
+    _data(static_cast<T*>(::operator new(sizeof(T) * N, std::align_val_t(alignof(T)))))
+{}
+
+template <typename T, uint32_t N>
+uninitialized_buffer<T, N>::~uninitialized_buffer() noexcept
+{
+    if (_data)
+    {
+        ::operator delete(_data, std::align_val_t(alignof(T)));
+    }
+}
+
+template <typename T, uint32_t N>
+uninitialized_buffer<T, N>::uninitialized_buffer(uninitialized_buffer&& other) noexcept :
+    _data(std::exchange(other._data, nullptr))
+{}
+
+template <typename T, uint32_t N>
+uninitialized_buffer<T, N>& uninitialized_buffer<T, N>::operator=(uninitialized_buffer&& other) noexcept
+{
+    std::swap(_data, other._data);
+    return *this;
+}
+
+template <typename T, uint32_t N>
+inline T* uninitialized_buffer<T, N>::data() const noexcept
+{
+    return _data;
+}
+
+template <typename T, uint32_t N>
+inline T* uninitialized_buffer<T, N>::end() const noexcept
+{
+    return _data + N;
+}
+
+template <typename T, uint32_t N>
+inline T& uninitialized_buffer<T, N>::operator[](std::size_t idx) const noexcept
+{
+    return _data[idx];
+}
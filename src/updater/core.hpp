@@ -1,35 +1,182 @@
 #pragma once
 
-#include <pools/fiber_pool.hpp>
+#include <synchronization/counter.hpp>
+#include <pool/fiber_pool.hpp>
+
+#include <array>
+#include <atomic>
+#include <cassert>
+#include <chrono>
+#include <functional>
+#include <vector>
+
+
+// Phases of a tick, in order. Each one is a barrier, all its work is done before the next one starts, with
+//  one exception: the serialization of a tick only reads what was simulated, thus it runs while the next
+//  tick waits and gathers its input, and simulation waits for it instead
+enum class tick_phase : uint8_t
+{
+    input,
+    simulate,
+    post_simulate,
+    serialize,
+    count
+};
 
 
 template <typename traits>
 class core
 {
 public:
+    using clock_t = std::chrono::steady_clock;
+
+    // Called once per tick, work is either done in place or pushed to the pool bound to the counter
+    using callback_t = std::function<void(np::counter&, np::fiber_pool<traits>*, uint64_t)>;
+
     core(uint16_t number_of_threads) noexcept;
 
+    template <typename F>
+    void on(tick_phase when, F&& callback) noexcept;
+
     template <typename T>
     void start(T&& main_loop) noexcept;
 
+    // Runs a tick every `timestep`. When lagging behind, up to `max_catch_up` ticks, at least one, are run back
+    //  to back and any further delay is dropped, the next tick then runs a timestep later
+    void run(clock_t::duration timestep, uint32_t max_catch_up = 5) noexcept;
+
+    // Can be called from any fiber, the current tick is finished first
+    void stop() noexcept;
+
+    inline np::fiber_pool<traits>* fiber_pool() noexcept;
+    inline uint64_t tick() const noexcept;
+
+private:
+    void loop(clock_t::duration timestep, uint32_t max_catch_up) noexcept;
+    void run_tick() noexcept;
+    void run_phase(tick_phase when) noexcept;
+
 private:
     np::fiber_pool<traits> _fiber_pool;
     uint16_t _number_of_threads;
+
+    std::array<std::vector<callback_t>, static_cast<std::size_t>(tick_phase::count)> _callbacks;
+    std::array<np::counter, static_cast<std::size_t>(tick_phase::count)> _barriers;
+
+    std::atomic<bool> _running;
+    std::atomic<uint64_t> _tick;
 };
 
 
 template <typename traits>
-core<traits>::core(uint16_t number_of_threads) :
+core<traits>::core(uint16_t number_of_threads) noexcept :
     _fiber_pool(),
-    _number_of_threads(number_of_threads)
+    _number_of_threads(number_of_threads),
+    _callbacks(),
+    _barriers(),
+    _running(false),
+    _tick(0)
 {}
 
+template <typename traits>
+template <typename F>
+void core<traits>::on(tick_phase when, F&& callback) noexcept
+{
+    _callbacks[static_cast<std::size_t>(when)].emplace_back(std::forward<F>(callback));
+}
 
 template <typename traits>
 template <typename T>
 void core<traits>::start(T&& main_loop) noexcept
 {
     _fiber_pool.push(std::forward<T>(main_loop));
-    _fiber_pool.start(number_of_threads);
+    _fiber_pool.start(_number_of_threads);
     // This point is only reached after the pool is stopped
 }
+
+template <typename traits>
+void core<traits>::run(clock_t::duration timestep, uint32_t max_catch_up) noexcept
+{
+    assert(max_catch_up > 0 && "At least one tick must run per timestep");
+
+    _running = true;
+    start([this, timestep, max_catch_up]() {
+        loop(timestep, max_catch_up);
+    });
+}
+
+template <typename traits>
+void core<traits>::stop() noexcept
+{
+    _running = false;
+}
+
+template <typename traits>
+inline np::fiber_pool<traits>* core<traits>::fiber_pool() noexcept
+{
+    return &_fiber_pool;
+}
+
+template <typename traits>
+inline uint64_t core<traits>::tick() const noexcept
+{
+    return _tick.load(std::memory_order_relaxed);
+}
+
+template <typename traits>
+void core<traits>::loop(clock_t::duration timestep, uint32_t max_catch_up) noexcept
+{
+    auto next = clock_t::now();
+    while (_running)
+    {
+        for (uint32_t ticks = 0; ticks < max_catch_up && _running && clock_t::now() >= next; ++ticks)
+        {
+            run_tick();
+            next += timestep;
+        }
+
+        // Still behind after catching up, the remaining delay is dropped
+        if (auto now = clock_t::now(); now > next)
+        {
+            next = now + timestep;
+        }
+
+        // Yielding keeps the worker helping with pending jobs, ie. serializing the last tick, instead of blocking it
+        while (_running && clock_t::now() < next)
+        {
+            np::this_fiber::yield();
+        }
+    }
+
+    _barriers[static_cast<std::size_t>(tick_phase::serialize)].wait();
+    _fiber_pool.end();
+}
+
+template <typename traits>
+void core<traits>::run_tick() noexcept
+{
+    // Input does not depend on the previous tick, and overlaps with its serialization
+    run_phase(tick_phase::input);
+    _barriers[static_cast<std::size_t>(tick_phase::input)].wait();
+
+    _barriers[static_cast<std::size_t>(tick_phase::serialize)].wait();
+    run_phase(tick_phase::simulate);
+    _barriers[static_cast<std::size_t>(tick_phase::simulate)].wait();
+
+    run_phase(tick_phase::post_simulate);
+    _barriers[static_cast<std::size_t>(tick_phase::post_simulate)].wait();
+
+    // Waited for by the next tick
+    run_phase(tick_phase::serialize);
+    _tick.fetch_add(1, std::memory_order_relaxed);
+}
+
+template <typename traits>
+void core<traits>::run_phase(tick_phase when) noexcept
+{
+    auto& barrier = _barriers[static_cast<std::size_t>(when)];
+    for (auto& callback : _callbacks[static_cast<std::size_t>(when)])
+    {
+        callback(barrier, &_fiber_pool, tick());
+    }
+}
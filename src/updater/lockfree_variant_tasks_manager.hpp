@@ -0,0 +1,177 @@
+#pragma once
+
+#include <pool/fiber_pool.hpp>
+#include "storage/ticket.hpp"
+#include "storage/uninitialized_buffer.hpp"
+
+#include <atomic>
+#include <memory>
+#include <new>
+#include <utility>
+#include <variant>
+
+
+// Same as `locking_variant_task_manager`, but each worker submits to its own single producer, single consumer
+//  queue. Fibers of a worker never run concurrently, thus submitting is a plain write and a release store, and
+//  `execute` only consumes what had been published when it started
+template <typename... Ts>
+class lockfree_variant_task_manager
+{
+    class spsc_queue
+    {
+        using value_t = std::variant<Ts...>;
+
+        static constexpr inline uint32_t block_size = 256;
+
+        struct block
+        {
+            uninitialized_buffer<value_t, block_size> values;
+            block* next = nullptr;
+        };
+
+    public:
+        spsc_queue() noexcept;
+        ~spsc_queue() noexcept;
+
+        spsc_queue(spsc_queue&& other) noexcept = delete;
+        spsc_queue& operator=(spsc_queue&& other) noexcept = delete;
+
+        template <typename T>
+        inline void submit(T&& value) noexcept;
+
+        template <typename V>
+        inline void consume(V& visitor) noexcept;
+
+    private:
+        inline block* acquire_block() noexcept;
+        inline void release_block(block* old) noexcept;
+
+    private:
+        // Producer side
+        alignas(64) block* _write_block;
+        uint64_t _written;
+        std::atomic<uint64_t> _published;
+
+        // Consumer side
+        alignas(64) block* _read_block;
+        uint64_t _consumed;
+
+        // A single fully consumed block is kept for the producer to reuse
+        alignas(64) std::atomic<block*> _spare;
+    };
+
+public:
+    template <typename T>
+    void submit(T&& value) noexcept;
+
+    template <typename V>
+    void execute(V&& visitor) noexcept;
+};
+
+
+template <typename... Ts>
+lockfree_variant_task_manager<Ts...>::spsc_queue::spsc_queue() noexcept :
+    _write_block(new block()),
+    _written(0),
+    _published(0),
+    _read_block(_write_block),
+    _consumed(0),
+    _spare(nullptr)
+{}
+
+template <typename... Ts>
+lockfree_variant_task_manager<Ts...>::spsc_queue::~spsc_queue() noexcept
+{
+    // Destroy whatever was never consumed
+    for (; _consumed < _published.load(std::memory_order_acquire); ++_consumed)
+    {
+        auto position = _consumed % block_size;
+        if (position == 0 && _consumed != 0)
+        {
+            release_block(std::exchange(_read_block, _read_block->next));
+        }
+
+        std::destroy_at(&_read_block->values[position]);
+    }
+
+    for (block* current = _read_block; current;)
+    {
+        delete std::exchange(current, current->next);
+    }
+
+    delete _spare.load(std::memory_order_relaxed);
+}
+
+template <typename... Ts>
+template <typename T>
+inline void lockfree_variant_task_manager<Ts...>::spsc_queue::submit(T&& value) noexcept
+{
+    auto position = _written % block_size;
+    if (position == 0 && _written != 0)
+    {
+        // Linked before publishing, thus the consumer always finds the next block
+        block* next = acquire_block();
+        _write_block->next = next;
+        _write_block = next;
+    }
+
+    new (&_write_block->values[position]) value_t(std::forward<T>(value));
+    _published.store(++_written, std::memory_order_release);
+}
+
+template <typename... Ts>
+template <typename V>
+inline void lockfree_variant_task_manager<Ts...>::spsc_queue::consume(V& visitor) noexcept
+{
+    // Values submitted while consuming, even by the visitor itself, are left for the next call
+    for (const uint64_t published = _published.load(std::memory_order_acquire); _consumed < published; ++_consumed)
+    {
+        auto position = _consumed % block_size;
+        if (position == 0 && _consumed != 0)
+        {
+            release_block(std::exchange(_read_block, _read_block->next));
+        }
+
+        auto& value = _read_block->values[position];
+        std::visit(visitor, value);
+        std::destroy_at(&value);
+    }
+}
+
+template <typename... Ts>
+inline auto lockfree_variant_task_manager<Ts...>::spsc_queue::acquire_block() noexcept -> block*
+{
+    if (block* spare = _spare.exchange(nullptr, std::memory_order_acquire))
+    {
+        spare->next = nullptr;
+        return spare;
+    }
+
+    return new block();
+}
+
+template <typename... Ts>
+inline void lockfree_variant_task_manager<Ts...>::spsc_queue::release_block(block* old) noexcept
+{
+    delete _spare.exchange(old, std::memory_order_acq_rel);
+}
+
+template <typename... Ts>
+template <typename T>
+void lockfree_variant_task_manager<Ts...>::submit(T&& value) noexcept
+{
+    auto& local_tasks = np::this_fiber::template threadlocal<spsc_queue>();
+    local_tasks.submit(std::forward<T>(value));
+}
+
+template <typename... Ts>
+template <typename V>
+void lockfree_variant_task_manager<Ts...>::execute(V&& visitor) noexcept
+{
+    auto fiber_pool = np::this_fiber::fiber_pool();
+    auto& per_thread_tasks = fiber_pool->template threadlocal_all<spsc_queue>();
+    for (uint8_t i = 0, size = fiber_pool->maximum_worker_id(); i < size; ++i)
+    {
+        per_thread_tasks[i].consume(visitor);
+    }
+}
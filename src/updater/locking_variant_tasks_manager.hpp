@@ -4,6 +4,7 @@
 #include <pool/fiber_pool.hpp>
 #include <synchronization/mutex.hpp>
 #include "storage/ticket.hpp"
+#include "updater/task_shards.hpp"
 
 #include <variant>
 #include <vector>
@@ -14,9 +15,9 @@ class locking_variant_task_manager
 {
     class dual_vector_scheduler
     {
+    public:
         using vector_t = std::vector<std::variant<Ts...>>;
 
-    public:
         dual_vector_scheduler() noexcept :
             _vector_1(),
             _vector_2()
@@ -61,6 +62,15 @@ public:
 
     template <typename V>
     void execute(V&& visitor) noexcept;
+
+    // Each worker buffer runs in its own job, thus the visitor must be safe to call concurrently
+    template <typename traits, typename V>
+    void execute_parallel(np::fiber_pool<traits>* pool, V&& visitor) noexcept;
+
+    // Tasks are sharded by `key(task)`, which returns an `uint64_t` (ie. an entity id). Tasks sharing a key
+    //  never run concurrently, and keep the order in which each worker submitted them
+    template <typename traits, typename V, typename K>
+    void execute_parallel(np::fiber_pool<traits>* pool, V&& visitor, K&& key) noexcept;
 };
 
 template <typename... Ts>
@@ -88,3 +98,66 @@ void locking_variant_task_manager<Ts...>::execute(V&& visitor) noexcept
         iter_safe_buffer.clear();
     }
 }
+
+template <typename... Ts>
+template <typename traits, typename V>
+void locking_variant_task_manager<Ts...>::execute_parallel(np::fiber_pool<traits>* pool, V&& visitor) noexcept
+{
+    auto& per_thread_tasks = pool->template threadlocal_all<dual_vector_scheduler>();
+    const uint8_t size = pool->maximum_worker_id();
+
+    // Swap everything before any task runs, visitors might be submitting on other workers
+    std::vector<typename dual_vector_scheduler::vector_t*> buffers(size);
+    for (uint8_t i = 0; i < size; ++i)
+    {
+        buffers[i] = &per_thread_tasks[i].swap();
+    }
+
+    np::counter counter;
+    for (auto iter_safe_buffer : buffers)
+    {
+        if (!iter_safe_buffer->empty())
+        {
+            pool->push([iter_safe_buffer, &visitor]()
+            {
+                for (auto&& variant : *iter_safe_buffer)
+                {
+                    std::visit(visitor, variant);
+                }
+
+                iter_safe_buffer->clear();
+            }, counter);
+        }
+    }
+
+    counter.wait();
+}
+
+template <typename... Ts>
+template <typename traits, typename V, typename K>
+void locking_variant_task_manager<Ts...>::execute_parallel(np::fiber_pool<traits>* pool, V&& visitor, K&& key) noexcept
+{
+    auto& per_thread_tasks = pool->template threadlocal_all<dual_vector_scheduler>();
+    const uint8_t size = pool->maximum_worker_id();
+
+    std::vector<typename dual_vector_scheduler::vector_t*> buffers(size);
+    auto shards = updater_detail::make_shards<std::variant<Ts...>>(size);
+    for (uint8_t i = 0; i < size; ++i)
+    {
+        buffers[i] = &per_thread_tasks[i].swap();
+        for (auto&& variant : *buffers[i])
+        {
+            updater_detail::shard(shards, std::visit(key, variant), &variant);
+        }
+    }
+
+    np::counter counter;
+    auto run = [&visitor](std::variant<Ts...>& variant) { std::visit(visitor, variant); };
+    updater_detail::push_shards(counter, pool, shards, run);
+    counter.wait();
+
+    for (auto iter_safe_buffer : buffers)
+    {
+        iter_safe_buffer->clear();
+    }
+}
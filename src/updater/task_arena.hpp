@@ -0,0 +1,222 @@
+#pragma once
+
+#include <algorithm>
+#include <cstddef>
+#include <inttypes.h>
+#include <memory>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+
+// Bump allocated, type erased closures. Each one is placed right after the previous one, preceded by a small
+//  header to call and destroy it, thus tasks are densely packed regardless of their size. Blocks of
+//  `block_size` bytes are kept when reset, so that once warmed up no allocation happens at all. Closures
+//  larger than a block get a block of their own
+template <uint32_t block_size>
+class task_arena
+{
+    // Closures are not bound by the block size, but blocks this small would mostly hold a single one
+    static_assert(block_size >= 1024, "Blocks are sized in bytes and should hold many closures");
+
+    struct block
+    {
+        block(std::size_t size) noexcept :
+            data(new std::byte[size]),
+            size(size)
+        {}
+
+        std::unique_ptr<std::byte[]> data;
+        std::size_t size;
+    };
+
+public:
+    struct task
+    {
+        // Calling a task runs and destroys the closure, it must be called exactly once before `reset`
+        inline void operator()() noexcept
+        {
+            call(this, true);
+        }
+
+        void (*call)(task*, bool) noexcept;
+        task* next;
+    };
+
+    task_arena() noexcept;
+    ~task_arena() noexcept;
+
+    task_arena(task_arena&& other) noexcept = delete;
+    task_arena& operator=(task_arena&& other) noexcept = delete;
+
+    template <typename F>
+    task* push(F&& function) noexcept;
+
+    // Runs every task in the order they were pushed, then resets the arena
+    void execute() noexcept;
+
+    // Forgets every task, which must have already been run
+    void reset() noexcept;
+
+    // Unlinks, in the order they were pushed, every task `predicate` holds for. `execute` then skips them, thus
+    //  they must be called by whoever unlinked them before the arena is reset
+    template <typename P>
+    void unlink_if(P&& predicate) noexcept;
+
+    inline bool empty() const noexcept;
+
+private:
+    template <typename F>
+    struct record : task
+    {
+        F closure;
+    };
+
+    template <typename R>
+    static void invoke(task* base, bool run) noexcept;
+
+    void* allocate(std::size_t size, std::size_t alignment) noexcept;
+
+private:
+    std::vector<block> _blocks;
+    std::size_t _current;
+    std::size_t _offset;
+
+    task* _first;
+    task* _last;
+};
+
+
+template <uint32_t block_size>
+task_arena<block_size>::task_arena() noexcept :
+    _blocks(),
+    _current(0),
+    _offset(0),
+    _first(nullptr),
+    _last(nullptr)
+{}
+
+template <uint32_t block_size>
+task_arena<block_size>::~task_arena() noexcept
+{
+    // Destroy whatever was never run
+    for (task* current = _first; current;)
+    {
+        task* old = std::exchange(current, current->next);
+        old->call(old, false);
+    }
+}
+
+template <uint32_t block_size>
+template <typename F>
+auto task_arena<block_size>::push(F&& function) noexcept -> task*
+{
+    using record_t = record<std::decay_t<F>>;
+
+    void* ptr = allocate(sizeof(record_t), alignof(record_t));
+    task* current = new (ptr) record_t{ { &task_arena::invoke<record_t>, nullptr }, std::forward<F>(function) };
+
+    if (_last)
+    {
+        _last->next = current;
+    }
+    else
+    {
+        _first = current;
+    }
+
+    _last = current;
+    return current;
+}
+
+template <uint32_t block_size>
+void task_arena<block_size>::execute() noexcept
+{
+    for (task* current = _first; current;)
+    {
+        // The closure is destroyed by the call, thus the next task is read first
+        (*std::exchange(current, current->next))();
+    }
+
+    reset();
+}
+
+template <uint32_t block_size>
+void task_arena<block_size>::reset() noexcept
+{
+    _current = 0;
+    _offset = 0;
+    _first = nullptr;
+    _last = nullptr;
+}
+
+template <uint32_t block_size>
+template <typename P>
+void task_arena<block_size>::unlink_if(P&& predicate) noexcept
+{
+    task* previous = nullptr;
+    for (task* current = _first; current; current = current->next)
+    {
+        if (!predicate(current))
+        {
+            previous = current;
+            continue;
+        }
+
+        if (previous)
+        {
+            previous->next = current->next;
+        }
+        else
+        {
+            _first = current->next;
+        }
+
+        if (_last == current)
+        {
+            _last = previous;
+        }
+    }
+}
+
+template <uint32_t block_size>
+inline bool task_arena<block_size>::empty() const noexcept
+{
+    return _first == nullptr;
+}
+
+template <uint32_t block_size>
+template <typename R>
+void task_arena<block_size>::invoke(task* base, bool run) noexcept
+{
+    auto current = static_cast<R*>(base);
+    if (run)
+    {
+        current->closure();
+    }
+
+    std::destroy_at(current);
+}
+
+template <uint32_t block_size>
+void* task_arena<block_size>::allocate(std::size_t size, std::size_t alignment) noexcept
+{
+    for (; _current < _blocks.size(); ++_current, _offset = 0)
+    {
+        void* ptr = _blocks[_current].data.get() + _offset;
+        std::size_t space = _blocks[_current].size - _offset;
+        if (std::align(alignment, size, ptr, space))
+        {
+            _offset = _blocks[_current].size - space + size;
+            return ptr;
+        }
+    }
+
+    // Out of blocks, a new one is always big enough to fit the closure once aligned
+    auto& last = _blocks.emplace_back(std::max<std::size_t>(block_size, size + alignment));
+    void* ptr = last.data.get();
+    std::size_t space = last.size;
+    std::align(alignment, size, ptr, space);
+    _offset = last.size - space + size;
+    return ptr;
+}
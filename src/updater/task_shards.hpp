@@ -0,0 +1,51 @@
+#pragma once
+
+#include <synchronization/counter.hpp>
+#include <pool/fiber_pool.hpp>
+
+#include <algorithm>
+#include <inttypes.h>
+#include <vector>
+
+
+namespace updater_detail
+{
+    // More shards than workers, so that skewed keys can still be balanced
+    inline constexpr uint32_t shards_per_worker = 4;
+
+    template <typename T>
+    using shards_t = std::vector<std::vector<T*>>;
+
+    template <typename T>
+    inline shards_t<T> make_shards(uint8_t workers) noexcept
+    {
+        return shards_t<T>(std::max<uint32_t>(workers, 1) * shards_per_worker);
+    }
+
+    // Tasks with the same key always end up in the same shard, and thus run in order
+    template <typename T>
+    inline void shard(shards_t<T>& shards, uint64_t key, T* task) noexcept
+    {
+        // Fibonacci hashing, so that consecutive ids are spread among shards
+        const auto hash = (key * 11400714819323198485ull) >> 32;
+        shards[hash % shards.size()].push_back(task);
+    }
+
+    template <typename traits, typename T, typename F>
+    inline void push_shards(np::counter& counter, np::fiber_pool<traits>* pool, shards_t<T>& shards, F& run) noexcept
+    {
+        for (auto& shard : shards)
+        {
+            if (!shard.empty())
+            {
+                pool->push([&shard, &run]()
+                {
+                    for (T* task : shard)
+                    {
+                        run(*task);
+                    }
+                }, counter);
+            }
+        }
+    }
+}
@@ -2,71 +2,153 @@
 
 #include <pool/fiber_pool.hpp>
 #include "storage/ticket.hpp"
+#include "updater/task_arena.hpp"
+#include "updater/task_shards.hpp"
+#include "updater/timer_wheel.hpp"
 
+#include <memory>
+#include <type_traits>
+#include <utility>
 #include <vector>
 
 
-template <uint32_t inplace_function_size>
+// Closures of any size are stored in per worker arenas of `block_size` bytes blocks, which are reused
+//  from one execution to the next
+template <uint32_t block_size = 16 * 1024>
 class task_manager
 {
-    class dual_vector_scheduler
+    // Used to be the inline size of each closure, which is now unbounded
+    static_assert(block_size >= 1024, "block_size is the size in bytes of each arena block, not of a closure");
+
+    // Closures of timed tasks, which need not be copyable. Periodic ones are shared with every task they
+    //  schedule, thus they are never copied and outlive a cancellation until those have run
+    struct timed_task
+    {
+        virtual ~timed_task() noexcept = default;
+        virtual void operator()() noexcept = 0;
+    };
+
+    template <typename F>
+    struct timed_closure : timed_task
     {
-        using vector_t = std::vector<stdext::inplace_function<void(), inplace_function_size>>;
+        template <typename G>
+        timed_closure(G&& closure) noexcept :
+            closure(std::forward<G>(closure))
+        {}
+
+        void operator()() noexcept override
+        {
+            closure();
+        }
 
+        F closure;
+    };
+
+    using timed_task_t = std::shared_ptr<timed_task>;
+
+public:
+    using task_t = typename task_arena<block_size>::task;
+    using timer_ticket = typename timer_wheel<timed_task_t>::ticket;
+
+private:
+    class dual_arena_scheduler
+    {
     public:
-        dual_vector_scheduler() noexcept :
-            _vector_1(),
-            _vector_2()
+        struct buffer
+        {
+            // Keyed tasks are pushed along the rest, so that `execute` keeps the submission order
+            task_arena<block_size> tasks;
+            std::vector<std::pair<uint64_t, task_t*>> keys;
+        };
+
+        dual_arena_scheduler() noexcept :
+            _buffer_1(),
+            _buffer_2()
         {
-            _current_vector = &_vector_1;
+            _current_buffer = &_buffer_1;
         }
 
-        inline vector_t& current() noexcept
+        inline buffer& current() noexcept
         {
-            return *_current_vector;
+            return *_current_buffer;
         }
 
-        inline vector_t& swap() noexcept
+        inline buffer& swap() noexcept
         {
-            vector_t* old = _current_vector;
-            if (_current_vector == &_vector_1)
+            buffer* old = _current_buffer;
+            if (_current_buffer == &_buffer_1)
             {
-                _current_vector = &_vector_2;
+                _current_buffer = &_buffer_2;
             }
             else
             {
-                _current_vector = &_vector_1;
+                _current_buffer = &_buffer_1;
             }
             return *old;
         }
 
     private:
-        vector_t* _current_vector;
-        vector_t _vector_1;
-        vector_t _vector_2;
+        buffer* _current_buffer;
+        buffer _buffer_1;
+        buffer _buffer_2;
     };
 
 public:
     template <typename F>
     void schedule(F&& function) noexcept;
 
+    // Tasks sharing a key (ie. an entity id) are never run concurrently by `execute_parallel`, and keep the
+    //  order in which each worker scheduled them
+    template <typename F>
+    void schedule(uint64_t key, F&& function) noexcept;
+
     template <typename F, typename... Args>
     void schedule_if(F&& function, Args&&... tickets) noexcept;
 
     void execute() noexcept;
+
+    // Runs each worker buffer in its own job, and keyed tasks sharded by key, waiting for all of them.
+    //  Tasks without a key may thus run concurrently with any other task
+    template <typename traits>
+    void execute_parallel(np::fiber_pool<traits>* pool) noexcept;
+
+    // Timed tasks are scheduled by `tick` once due, thus they run on the following execution
+    template <typename F>
+    timer_ticket schedule_in(uint32_t ticks, F&& function) noexcept;
+
+    // Runs every `period` ticks, starting `period` ticks from now, until cancelled
+    template <typename F>
+    timer_ticket schedule_every(uint32_t period, F&& function) noexcept;
+
+    void cancel(timer_ticket ticket) noexcept;
+
+    // Must be called from inside the pool, when no fiber is scheduling nor cancelling timed tasks
+    void tick() noexcept;
+
+private:
+    timer_wheel<timed_task_t> _timers;
 };
 
-template <uint32_t inplace_function_size>
+template <uint32_t block_size>
+template <typename F>
+void task_manager<block_size>::schedule(F&& function) noexcept
+{
+    auto& local_tasks = np::this_fiber::template threadlocal<dual_arena_scheduler>();
+    local_tasks.current().tasks.push(std::forward<F>(function));
+}
+
+template <uint32_t block_size>
 template <typename F>
-void task_manager<inplace_function_size>::schedule(F&& function) noexcept
+void task_manager<block_size>::schedule(uint64_t key, F&& function) noexcept
 {
-    auto& local_tasks = np::this_fiber::template threadlocal<dual_vector_scheduler>();
-    local_tasks.current().push_back(std::forward<F>(function));
+    auto& local_tasks = np::this_fiber::template threadlocal<dual_arena_scheduler>();
+    auto& buffer = local_tasks.current();
+    buffer.keys.emplace_back(key, buffer.tasks.push(std::forward<F>(function)));
 }
 
-template <uint32_t inplace_function_size>
+template <uint32_t block_size>
 template <typename F, typename... Args>
-void task_manager<inplace_function_size>::schedule_if(F&& function, Args&&... tickets) noexcept
+void task_manager<block_size>::schedule_if(F&& function, Args&&... tickets) noexcept
 {
     schedule([function = std::move(function), tickets...]() mutable {
         if ((tickets->valid() && ...))
@@ -76,19 +158,100 @@ void task_manager<inplace_function_size>::schedule_if(F&& function, Args&&... ti
     });
 }
 
-template <uint32_t inplace_function_size>
-void task_manager<inplace_function_size>::execute() noexcept
+template <uint32_t block_size>
+void task_manager<block_size>::execute() noexcept
 {
     auto fiber_pool = np::this_fiber::fiber_pool();
-    auto& per_thread_tasks = fiber_pool->template threadlocal_all<dual_vector_scheduler>();
+    auto& per_thread_tasks = fiber_pool->template threadlocal_all<dual_arena_scheduler>();
     for (uint8_t i = 0, size = fiber_pool->maximum_worker_id(); i < size; ++i)
     {
         auto& iter_safe_buffer = per_thread_tasks[i].swap();
-        for (auto&& task : iter_safe_buffer)
+        iter_safe_buffer.tasks.execute();
+        iter_safe_buffer.keys.clear();
+    }
+}
+
+template <uint32_t block_size>
+template <typename traits>
+void task_manager<block_size>::execute_parallel(np::fiber_pool<traits>* pool) noexcept
+{
+    auto& per_thread_tasks = pool->template threadlocal_all<dual_arena_scheduler>();
+    const uint8_t size = pool->maximum_worker_id();
+
+    // Swap everything before any task runs, tasks might be scheduling on other workers
+    std::vector<typename dual_arena_scheduler::buffer*> buffers(size);
+    auto shards = updater_detail::make_shards<task_t>(size);
+    for (uint8_t i = 0; i < size; ++i)
+    {
+        buffers[i] = &per_thread_tasks[i].swap();
+        for (auto [key, task] : buffers[i]->keys)
+        {
+            updater_detail::shard(shards, key, task);
+        }
+
+        // Keyed tasks run from their shards instead, keys are in the same order as the tasks
+        buffers[i]->tasks.unlink_if([it = buffers[i]->keys.begin(), end = buffers[i]->keys.end()](task_t* task) mutable {
+            if (it != end && it->second == task)
+            {
+                ++it;
+                return true;
+            }
+
+            return false;
+        });
+    }
+
+    np::counter counter;
+    for (auto iter_safe_buffer : buffers)
+    {
+        if (!iter_safe_buffer->tasks.empty())
         {
-            task();
+            pool->push([iter_safe_buffer]()
+            {
+                iter_safe_buffer->tasks.execute();
+            }, counter);
         }
+    }
+
+    auto run = [](task_t& task) { task(); };
+    updater_detail::push_shards(counter, pool, shards, run);
+    counter.wait();
 
-        iter_safe_buffer.clear();
+    for (auto iter_safe_buffer : buffers)
+    {
+        iter_safe_buffer->tasks.reset();
+        iter_safe_buffer->keys.clear();
     }
 }
+
+template <uint32_t block_size>
+template <typename F>
+auto task_manager<block_size>::schedule_in(uint32_t ticks, F&& function) noexcept -> timer_ticket
+{
+    return _timers.schedule(ticks, 0, std::make_shared<timed_closure<std::decay_t<F>>>(std::forward<F>(function)));
+}
+
+template <uint32_t block_size>
+template <typename F>
+auto task_manager<block_size>::schedule_every(uint32_t period, F&& function) noexcept -> timer_ticket
+{
+    assert(period > 0 && "Periodic tasks need a period");
+    return _timers.schedule(period, period, std::make_shared<timed_closure<std::decay_t<F>>>(std::forward<F>(function)));
+}
+
+template <uint32_t block_size>
+void task_manager<block_size>::cancel(timer_ticket ticket) noexcept
+{
+    _timers.cancel(ticket);
+}
+
+template <uint32_t block_size>
+void task_manager<block_size>::tick() noexcept
+{
+    // One-shot closures are moved into the task, periodic ones only add a reference
+    _timers.tick([this](auto&& function) {
+        schedule([function = timed_task_t(std::forward<decltype(function)>(function))]() {
+            (*function)();
+        });
+    });
+}
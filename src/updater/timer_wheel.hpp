@@ -0,0 +1,346 @@
+#pragma once
+
+#include <pool/fiber_pool.hpp>
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <cassert>
+#include <inttypes.h>
+#include <limits>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <utility>
+#include <vector>
+
+
+// Hierarchical timing wheel, four levels of 256 slots each. Timers are linked into the slot of the level that
+//  covers how far they expire, and are cascaded one level down whenever a lower level wraps around, thus
+//  inserting, cancelling and expiring are constant time.
+// Timers are scheduled and cancelled from fibers into per worker storage, which needs no synchronization, and
+//  applied by `tick`. That storage is owned by the wheel, workers only keep a lookup entry to it
+template <typename T>
+class timer_wheel
+{
+    static constexpr inline uint32_t levels = 4;
+    static constexpr inline uint32_t slot_bits = 8;
+    static constexpr inline uint32_t slots = 1 << slot_bits;
+
+    // Nodes are referred to by the storage that owns them and their index in it
+    static constexpr inline uint32_t index_bits = 24;
+    static constexpr inline uint32_t npos = std::numeric_limits<uint32_t>::max();
+
+    struct node
+    {
+        std::optional<T> value;
+        uint64_t expires;
+        uint32_t period;
+        uint32_t generation;
+        uint32_t prev;
+        uint32_t next;
+        uint32_t slot;
+    };
+
+    struct local_timers
+    {
+        std::vector<node> nodes;
+        std::vector<uint32_t> free;
+        std::vector<uint32_t> pending;
+        std::vector<std::pair<local_timers*, std::pair<uint32_t, uint32_t>>> cancels;
+
+        // Position in the wheel storages
+        uint32_t owner;
+    };
+
+    // Every wheel of the same type shares the per worker lookup. Wheels are looked up by an id, which is never
+    //  reused, thus entries left by destroyed wheels are harmless
+    using local_storage = std::vector<std::pair<uint64_t, local_timers*>>;
+
+public:
+    class ticket
+    {
+        friend class timer_wheel;
+
+    public:
+        constexpr ticket() noexcept :
+            _local(nullptr),
+            _index(0),
+            _generation(0)
+        {}
+
+    private:
+        constexpr ticket(local_timers* local, uint32_t index, uint32_t generation) noexcept :
+            _local(local),
+            _index(index),
+            _generation(generation)
+        {}
+
+    private:
+        local_timers* _local;
+        uint32_t _index;
+        uint32_t _generation;
+    };
+
+    timer_wheel() noexcept;
+
+    // Destroys every pending timer, may be called from outside the fiber pool
+    ~timer_wheel() noexcept = default;
+
+    timer_wheel(timer_wheel&& other) noexcept = delete;
+    timer_wheel& operator=(timer_wheel&& other) noexcept = delete;
+
+    // Expires after `ticks` ticks, at least one. Periodic timers (`period` not 0) are then rescheduled every
+    //  `period` ticks until cancelled
+    template <typename V>
+    ticket schedule(uint32_t ticks, uint32_t period, V&& value) noexcept;
+
+    // Cancelling an expired one-shot timer, or an already cancelled one, does nothing
+    void cancel(ticket timer) noexcept;
+
+    // Must be called from inside the fiber pool, when no fiber is scheduling nor cancelling timers. Advances
+    //  one tick and calls `expired` once per due timer, with an rvalue for one-shot timers and a const lvalue
+    //  for periodic ones
+    template <typename F>
+    void tick(F&& expired) noexcept;
+
+    inline uint64_t now() const noexcept;
+
+private:
+    local_timers& local() noexcept;
+
+    inline node& at(uint32_t ref) noexcept;
+    void link(uint32_t ref) noexcept;
+    void unlink(uint32_t ref) noexcept;
+    void release(local_timers& local, uint32_t index) noexcept;
+
+    uint32_t detach(uint32_t slot) noexcept;
+
+private:
+    static inline std::atomic<uint64_t> _next_id = 0;
+
+    uint64_t _id;
+    uint64_t _now;
+    std::array<uint32_t, levels * slots> _heads;
+
+    // One storage per worker that ever scheduled or cancelled, only added to when a worker first does so
+    std::mutex _locals_mutex;
+    std::vector<std::unique_ptr<local_timers>> _locals;
+};
+
+
+template <typename T>
+timer_wheel<T>::timer_wheel() noexcept :
+    _id(_next_id.fetch_add(1, std::memory_order_relaxed)),
+    _now(0),
+    _heads(),
+    _locals_mutex(),
+    _locals()
+{
+    _heads.fill(npos);
+}
+
+template <typename T>
+template <typename V>
+typename timer_wheel<T>::ticket timer_wheel<T>::schedule(uint32_t ticks, uint32_t period, V&& value) noexcept
+{
+    auto& local = this->local();
+
+    uint32_t index;
+    if (local.free.empty())
+    {
+        index = static_cast<uint32_t>(local.nodes.size());
+        local.nodes.emplace_back();
+        assert(index < (1 << index_bits) && "Too many timers in a single worker");
+    }
+    else
+    {
+        index = local.free.back();
+        local.free.pop_back();
+    }
+
+    // Ticks only happen when no fiber is scheduling, thus `_now` is stable here
+    auto& timer = local.nodes[index];
+    timer.value.emplace(std::forward<V>(value));
+    timer.expires = _now + std::max<uint32_t>(ticks, 1);
+    timer.period = period;
+
+    local.pending.push_back(index);
+    return ticket(&local, index, timer.generation);
+}
+
+template <typename T>
+void timer_wheel<T>::cancel(ticket timer) noexcept
+{
+    if (timer._local)
+    {
+        local().cancels.emplace_back(timer._local, std::make_pair(timer._index, timer._generation));
+    }
+}
+
+template <typename T>
+template <typename F>
+void timer_wheel<T>::tick(F&& expired) noexcept
+{
+    // Link every new timer before cancelling, as they might be cancelled already
+    for (auto& local : _locals)
+    {
+        for (auto index : local->pending)
+        {
+            link((local->owner << index_bits) | index);
+        }
+
+        local->pending.clear();
+    }
+
+    for (auto& local : _locals)
+    {
+        for (auto [owner, timer] : local->cancels)
+        {
+            auto [index, generation] = timer;
+            // Live timers are always linked at this point
+            if (auto& node = owner->nodes[index]; node.generation == generation && node.value)
+            {
+                unlink((owner->owner << index_bits) | index);
+                release(*owner, index);
+            }
+        }
+
+        local->cancels.clear();
+    }
+
+    ++_now;
+
+    // Higher levels first, so that timers cascaded into a lower level slot that is due now are not missed
+    for (uint32_t level = levels - 1; level > 0; --level)
+    {
+        if ((_now & ((uint64_t(1) << (slot_bits * level)) - 1)) == 0)
+        {
+            for (uint32_t ref = detach(level * slots + ((_now >> (slot_bits * level)) & (slots - 1))); ref != npos;)
+            {
+                auto next = at(ref).next;
+                link(ref);
+                ref = next;
+            }
+        }
+    }
+
+    // Detached first, so that periodic timers are relinked without being seen again
+    for (uint32_t ref = detach(_now & (slots - 1)); ref != npos;)
+    {
+        auto& timer = at(ref);
+        auto next = timer.next;
+
+        if (timer.period)
+        {
+            expired(std::as_const(*timer.value));
+            timer.expires = _now + timer.period;
+            link(ref);
+        }
+        else
+        {
+            expired(std::move(*timer.value));
+            release(*_locals[ref >> index_bits], ref & ((1 << index_bits) - 1));
+        }
+
+        ref = next;
+    }
+}
+
+template <typename T>
+inline uint64_t timer_wheel<T>::now() const noexcept
+{
+    return _now;
+}
+
+template <typename T>
+typename timer_wheel<T>::local_timers& timer_wheel<T>::local() noexcept
+{
+    auto& storages = np::this_fiber::template threadlocal<local_storage>();
+    for (auto [id, local] : storages)
+    {
+        if (id == _id)
+        {
+            return *local;
+        }
+    }
+
+    // First time this worker uses the wheel
+    local_timers* local;
+    {
+        std::lock_guard<std::mutex> lock(_locals_mutex);
+        local = _locals.emplace_back(std::make_unique<local_timers>()).get();
+        local->owner = static_cast<uint32_t>(_locals.size() - 1);
+        assert(local->owner < (1 << (32 - index_bits)) && "Too many workers for a single wheel");
+    }
+
+    return *storages.emplace_back(_id, local).second;
+}
+
+template <typename T>
+inline typename timer_wheel<T>::node& timer_wheel<T>::at(uint32_t ref) noexcept
+{
+    return _locals[ref >> index_bits]->nodes[ref & ((1 << index_bits) - 1)];
+}
+
+template <typename T>
+void timer_wheel<T>::link(uint32_t ref) noexcept
+{
+    auto& timer = at(ref);
+    assert(timer.expires >= _now && "Timers can't expire in the past");
+
+    // The lowest level whose range covers the remaining ticks, those due now are linked to the current slot
+    const uint64_t delta = timer.expires - _now;
+    uint32_t level = 0;
+    while (level < levels - 1 && delta >= (uint64_t(1) << (slot_bits * (level + 1))))
+    {
+        ++level;
+    }
+
+    timer.slot = level * slots + ((timer.expires >> (slot_bits * level)) & (slots - 1));
+    timer.prev = npos;
+    timer.next = _heads[timer.slot];
+    if (timer.next != npos)
+    {
+        at(timer.next).prev = ref;
+    }
+
+    _heads[timer.slot] = ref;
+}
+
+template <typename T>
+void timer_wheel<T>::unlink(uint32_t ref) noexcept
+{
+    auto& timer = at(ref);
+    if (timer.prev == npos)
+    {
+        _heads[timer.slot] = timer.next;
+    }
+    else
+    {
+        at(timer.prev).next = timer.next;
+    }
+
+    if (timer.next != npos)
+    {
+        at(timer.next).prev = timer.prev;
+    }
+
+    timer.slot = npos;
+}
+
+template <typename T>
+void timer_wheel<T>::release(local_timers& local, uint32_t index) noexcept
+{
+    auto& timer = local.nodes[index];
+    timer.value.reset();
+    timer.slot = npos;
+    ++timer.generation;
+    local.free.push_back(index);
+}
+
+template <typename T>
+uint32_t timer_wheel<T>::detach(uint32_t slot) noexcept
+{
+    return std::exchange(_heads[slot], npos);
+}
@@ -2,7 +2,11 @@
 
 #include <pool/fiber_pool.hpp>
 #include "storage/ticket.hpp"
+#include "updater/task_shards.hpp"
+#include "updater/timer_wheel.hpp"
 
+#include <span>
+#include <tuple>
 #include <variant>
 #include <vector>
 
@@ -12,9 +16,9 @@ class variant_task_manager
 {
     class dual_vector_scheduler
     {
+    public:
         using vector_t = std::vector<std::variant<Ts...>>;
 
-    public:
         dual_vector_scheduler() noexcept :
             _vector_1(),
             _vector_2()
@@ -48,11 +52,52 @@ class variant_task_manager
     };
 
 public:
+    using timer_ticket = typename timer_wheel<std::variant<Ts...>>::ticket;
+
     template <typename T>
     void submit(T&& value) noexcept;
 
     template <typename V>
     void execute(V&& visitor) noexcept;
+
+    // Each worker buffer runs in its own job, thus the visitor must be safe to call concurrently
+    template <typename traits, typename V>
+    void execute_parallel(np::fiber_pool<traits>* pool, V&& visitor) noexcept;
+
+    // Tasks are sharded by `key(task)`, which returns an `uint64_t` (ie. an entity id). Tasks sharing a key
+    //  never run concurrently, and keep the order in which each worker submitted them
+    template <typename traits, typename V, typename K>
+    void execute_parallel(np::fiber_pool<traits>* pool, V&& visitor, K&& key) noexcept;
+
+    // As `execute`, but all tasks of the same alternative run one after the other, in the order of `Ts`.
+    //  Within an alternative, tasks keep the order in which each worker submitted them
+    template <typename V>
+    void execute_grouped(V&& visitor) noexcept;
+
+    // The visitor is called once per alternative with tasks, with a `std::span<const T>` holding all of them
+    template <typename V>
+    void execute_batched(V&& visitor) noexcept;
+
+    // Timed values are submitted by `tick` once due, thus they are visited on the following execution
+    template <typename T>
+    timer_ticket submit_in(uint32_t ticks, T&& value) noexcept;
+
+    // Submitted every `period` ticks, starting `period` ticks from now, until cancelled
+    template <typename T>
+    timer_ticket submit_every(uint32_t period, T&& value) noexcept;
+
+    void cancel(timer_ticket ticket) noexcept;
+
+    // Must be called from inside the pool, when no fiber is submitting nor cancelling timed values
+    void tick() noexcept;
+
+private:
+    void gather() noexcept;
+
+private:
+    // Reused between calls, so that buckets keep their capacity
+    std::tuple<std::vector<Ts>...> _batches;
+    timer_wheel<std::variant<Ts...>> _timers;
 };
 
 template <typename... Ts>
@@ -80,3 +125,155 @@ void variant_task_manager<Ts...>::execute(V&& visitor) noexcept
         iter_safe_buffer.clear();
     }
 }
+
+template <typename... Ts>
+template <typename V>
+void variant_task_manager<Ts...>::execute_grouped(V&& visitor) noexcept
+{
+    gather();
+
+    std::apply([&visitor](auto&... batches) {
+        auto run = [&visitor](auto& batch) {
+            for (auto& task : batch)
+            {
+                visitor(task);
+            }
+
+            batch.clear();
+        };
+
+        (run(batches), ...);
+    }, _batches);
+}
+
+template <typename... Ts>
+template <typename V>
+void variant_task_manager<Ts...>::execute_batched(V&& visitor) noexcept
+{
+    gather();
+
+    std::apply([&visitor](auto&... batches) {
+        auto run = [&visitor](auto& batch) {
+            using task_t = typename std::decay_t<decltype(batch)>::value_type;
+            if (!batch.empty())
+            {
+                visitor(std::span<const task_t>(batch));
+            }
+
+            batch.clear();
+        };
+
+        (run(batches), ...);
+    }, _batches);
+}
+
+template <typename... Ts>
+void variant_task_manager<Ts...>::gather() noexcept
+{
+    auto fiber_pool = np::this_fiber::fiber_pool();
+    auto& per_thread_tasks = fiber_pool->template threadlocal_all<dual_vector_scheduler>();
+    for (uint8_t i = 0, size = fiber_pool->maximum_worker_id(); i < size; ++i)
+    {
+        auto& iter_safe_buffer = per_thread_tasks[i].swap();
+        for (auto&& variant : iter_safe_buffer)
+        {
+            std::visit([this](auto& task) {
+                std::get<std::vector<std::decay_t<decltype(task)>>>(_batches).push_back(std::move(task));
+            }, variant);
+        }
+
+        iter_safe_buffer.clear();
+    }
+}
+
+template <typename... Ts>
+template <typename traits, typename V>
+void variant_task_manager<Ts...>::execute_parallel(np::fiber_pool<traits>* pool, V&& visitor) noexcept
+{
+    auto& per_thread_tasks = pool->template threadlocal_all<dual_vector_scheduler>();
+    const uint8_t size = pool->maximum_worker_id();
+
+    // Swap everything before any task runs, visitors might be submitting on other workers
+    std::vector<typename dual_vector_scheduler::vector_t*> buffers(size);
+    for (uint8_t i = 0; i < size; ++i)
+    {
+        buffers[i] = &per_thread_tasks[i].swap();
+    }
+
+    np::counter counter;
+    for (auto iter_safe_buffer : buffers)
+    {
+        if (!iter_safe_buffer->empty())
+        {
+            pool->push([iter_safe_buffer, &visitor]()
+            {
+                for (auto&& variant : *iter_safe_buffer)
+                {
+                    std::visit(visitor, variant);
+                }
+
+                iter_safe_buffer->clear();
+            }, counter);
+        }
+    }
+
+    counter.wait();
+}
+
+template <typename... Ts>
+template <typename traits, typename V, typename K>
+void variant_task_manager<Ts...>::execute_parallel(np::fiber_pool<traits>* pool, V&& visitor, K&& key) noexcept
+{
+    auto& per_thread_tasks = pool->template threadlocal_all<dual_vector_scheduler>();
+    const uint8_t size = pool->maximum_worker_id();
+
+    std::vector<typename dual_vector_scheduler::vector_t*> buffers(size);
+    auto shards = updater_detail::make_shards<std::variant<Ts...>>(size);
+    for (uint8_t i = 0; i < size; ++i)
+    {
+        buffers[i] = &per_thread_tasks[i].swap();
+        for (auto&& variant : *buffers[i])
+        {
+            updater_detail::shard(shards, std::visit(key, variant), &variant);
+        }
+    }
+
+    np::counter counter;
+    auto run = [&visitor](std::variant<Ts...>& variant) { std::visit(visitor, variant); };
+    updater_detail::push_shards(counter, pool, shards, run);
+    counter.wait();
+
+    for (auto iter_safe_buffer : buffers)
+    {
+        iter_safe_buffer->clear();
+    }
+}
+
+template <typename... Ts>
+template <typename T>
+auto variant_task_manager<Ts...>::submit_in(uint32_t ticks, T&& value) noexcept -> timer_ticket
+{
+    return _timers.schedule(ticks, 0, std::forward<T>(value));
+}
+
+template <typename... Ts>
+template <typename T>
+auto variant_task_manager<Ts...>::submit_every(uint32_t period, T&& value) noexcept -> timer_ticket
+{
+    assert(period > 0 && "Periodic values need a period");
+    return _timers.schedule(period, period, std::forward<T>(value));
+}
+
+template <typename... Ts>
+void variant_task_manager<Ts...>::cancel(timer_ticket ticket) noexcept
+{
+    _timers.cancel(ticket);
+}
+
+template <typename... Ts>
+void variant_task_manager<Ts...>::tick() noexcept
+{
+    _timers.tick([this](auto&& value) {
+        submit(std::forward<decltype(value)>(value));
+    });
+}
@@ -0,0 +1,56 @@
+#pragma once
+
+#include "common/prefetch.hpp"
+
+#include <tao/tuple/tuple.hpp>
+
+#include <algorithm>
+#include <array>
+#include <inttypes.h>
+
+
+namespace view_detail
+{
+    // Enough entities in flight to hide memory latency, while the batch still fits in L1
+    inline constexpr uint32_t search_batch_size = 32;
+
+    // Resolves `count` entities starting at `it` in blocks, walking each block once per level of the
+    // lookup: first prefetching the index slots, then the index entries, then resolving the entities and
+    // prefetching their components, and only then invoking the callback. Thus the cache misses of each
+    // level overlap among the entities of the block instead of being paid one after the other
+    template <typename S, typename I, typename C>
+    inline void for_each_batched(S& scheme, I it, std::size_t count, C& callback) noexcept
+    {
+        using entity_t = decltype(scheme.search(0));
+        std::array<uint64_t, search_batch_size> ids;
+        std::array<entity_t, search_batch_size> batch;
+
+        while (count > 0)
+        {
+            const auto size = static_cast<uint32_t>(std::min<std::size_t>(count, search_batch_size));
+            for (uint32_t idx = 0; idx < size; ++idx, ++it)
+            {
+                ids[idx] = (*it)->id();
+                scheme.prefetch(ids[idx]);
+            }
+
+            for (uint32_t idx = 0; idx < size; ++idx)
+            {
+                scheme.prefetch_entry(ids[idx]);
+            }
+
+            for (uint32_t idx = 0; idx < size; ++idx)
+            {
+                batch[idx] = scheme.search(ids[idx]);
+                tao::apply([](auto... components) { (::prefetch(components), ...); }, batch[idx].downcast());
+            }
+
+            for (uint32_t idx = 0; idx < size; ++idx)
+            {
+                tao::apply(callback, batch[idx].downcast());
+            }
+
+            count -= size;
+        }
+    }
+}
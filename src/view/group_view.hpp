@@ -0,0 +1,62 @@
+#pragma once
+
+#include <synchronization/counter.hpp>
+#include <pool/fiber_pool.hpp>
+
+#include "view/view_slices.hpp"
+
+
+// Views over an `owning_group`. Its members are index aligned, thus there are no searches nor
+// layout requirements, but the group must not be refreshed nor written while iterating
+struct group_view
+{
+    template <typename traits, template <typename...> class G, typename C, typename... types>
+    inline static constexpr void continuous(np::counter& counter, np::fiber_pool<traits>* pool, G<types...>& group, C&& callback) noexcept
+    {
+        group.refresh();
+        if (group.size() == 0)
+        {
+            return;
+        }
+
+        pool->push([&group, callback = std::move(callback)]()
+        {
+            for (auto combined : group.range())
+            {
+                std::apply(callback, combined);
+            }
+        }, counter);
+
+#if !defined(NDEBUG)
+        counter.on_wait_done([&group]() {
+            (..., group.template get<types>().unlock_writes());
+            });
+#endif
+    }
+
+    // Each job processes a contiguous slice of `grain` entities (0 to auto-tune)
+    template <typename traits, template <typename...> class G, typename C, typename... types>
+    inline static constexpr void parallel_chunked(np::counter& counter, np::fiber_pool<traits>* pool, G<types...>& group, C&& callback, uint32_t grain = 0) noexcept
+    {
+        group.refresh();
+        if (group.size() == 0)
+        {
+            return;
+        }
+
+        view_detail::push_slice_jobs(counter, pool, group.size(), grain,
+            [&group, callback = std::forward<C>(callback)](std::size_t begin, std::size_t count) mutable
+            {
+                view_detail::for_each_zipped(begin, count, callback, group.template get<types>().spans()...);
+            });
+
+#if !defined(NDEBUG)
+        counter.on_wait_done([&group]() {
+            (..., group.template get<types>().unlock_writes());
+            });
+#endif
+    }
+
+private:
+    group_view();
+};
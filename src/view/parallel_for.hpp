@@ -0,0 +1,101 @@
+#pragma once
+
+#include <synchronization/counter.hpp>
+#include <pool/fiber_pool.hpp>
+
+#include "view/view_slices.hpp"
+
+#include <algorithm>
+#include <atomic>
+#include <inttypes.h>
+#include <memory>
+
+
+namespace view_detail
+{
+    template <typename traits, typename R, typename F>
+    struct parallel_for_state
+    {
+        np::fiber_pool<traits>* pool;
+        np::counter* counter;
+        R make_spans;
+        F callback;
+        uint32_t grain;
+
+        // Tasks pushed but not yet picked up by any worker
+        std::atomic<int32_t> pending;
+    };
+
+    template <typename S>
+    void parallel_for_push(const std::shared_ptr<S>& state, std::size_t begin, std::size_t end) noexcept;
+
+    template <typename S>
+    void parallel_for_task(const std::shared_ptr<S>& state, std::size_t begin, std::size_t end) noexcept
+    {
+        state->pending.fetch_sub(1, std::memory_order_relaxed);
+
+        auto it = span_cursor(state->make_spans(), begin);
+        while (begin < end)
+        {
+            // All pushed work has been taken, thus some worker is idle: give away the upper half
+            if (end - begin >= 2 * state->grain && state->pending.load(std::memory_order_relaxed) <= 0)
+            {
+                auto middle = begin + (end - begin) / 2;
+                parallel_for_push(state, middle, end);
+                end = middle;
+            }
+
+            for (auto step_end = std::min(end, begin + state->grain); begin < step_end; ++begin, ++it)
+            {
+                state->callback(*it);
+            }
+        }
+    }
+
+    template <typename S>
+    void parallel_for_push(const std::shared_ptr<S>& state, std::size_t begin, std::size_t end) noexcept
+    {
+        state->pending.fetch_add(1, std::memory_order_relaxed);
+        state->pool->push([state, begin, end]()
+        {
+            parallel_for_task(state, begin, end);
+        }, *state->counter);
+    }
+}
+
+
+// Adaptive parallel loop over the elements of `make_spans()`, a list of spans holding `size` elements.
+// It starts with one large task per worker and only splits a task in halves when every pushed task has
+// already been picked up, so that skewed workloads still keep all workers busy until the end.
+// The callback is shared by all tasks, thus it must be safe to invoke concurrently
+template <typename traits, typename R, typename C>
+inline void parallel_for(np::counter& counter, np::fiber_pool<traits>* pool, std::size_t size, R&& make_spans, C&& callback, uint32_t grain = 0) noexcept
+{
+    if (size == 0)
+    {
+        return;
+    }
+
+    using state_t = view_detail::parallel_for_state<traits, std::decay_t<R>, std::decay_t<C>>;
+    auto state = std::make_shared<state_t>(pool, &counter, std::forward<R>(make_spans), std::forward<C>(callback),
+        grain ? grain : view_detail::minimum_grain, 0);
+
+    const std::size_t workers = std::max<std::size_t>(pool->maximum_worker_id(), 1);
+    const std::size_t initial = std::max<std::size_t>(size / workers, state->grain);
+    for (std::size_t begin = 0; begin < size; begin += initial)
+    {
+        view_detail::parallel_for_push(state, begin, std::min(size, begin + initial));
+    }
+}
+
+template <typename traits, typename O, typename C>
+inline void parallel_for(np::counter& counter, np::fiber_pool<traits>* pool, O& orchestrator, C&& callback, uint32_t grain = 0) noexcept
+{
+    parallel_for(counter, pool, orchestrator.size(), [&orchestrator]() { return orchestrator.spans(); }, std::forward<C>(callback), grain);
+
+#if !defined(NDEBUG)
+    counter.on_wait_done([&orchestrator]() {
+        orchestrator.unlock_writes();
+    });
+#endif
+}
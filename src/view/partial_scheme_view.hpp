@@ -3,6 +3,8 @@
 #include <synchronization/counter.hpp>
 #include <pool/fiber_pool.hpp>
 
+#include "view/scheme_view_detail.hpp"
+
 
 template <typename... components>
 struct partial_scheme_view
@@ -49,7 +51,7 @@ struct partial_scheme_view
             auto& component = scheme.template get<By>();
             for (auto obj : component.range())
             {
-                std::apply(callback, scheme.search(obj->id()));
+                tao::apply(callback, scheme.search(obj->id()).downcast());
             }
         }, counter);
 
@@ -76,7 +78,7 @@ struct partial_scheme_view
 
         for (auto combined : ::ranges::views::zip(scheme.template get<components>().range()...))
         {
-            pool->push([&scheme, combined, callback = std::move(callback)]() mutable
+            pool->push([&scheme, combined, callback]() mutable
             {
                 std::apply(callback, combined);
             }, counter);
@@ -89,7 +91,7 @@ struct partial_scheme_view
 #endif
     }
 
-    template <typename By, typename traits, template <typename...> class S, typename O, typename C, typename... types>
+    template <typename By, typename traits, template <typename...> class S, typename C, typename... types>
     inline static constexpr void parallel_by(np::counter& counter, np::fiber_pool<traits>* pool, S<types...>& scheme, C&& callback) noexcept
     {
         if (scheme.size() == 0)
@@ -100,9 +102,9 @@ struct partial_scheme_view
         auto& component = scheme.template get<By>();
         for (auto obj : component.range())
         {
-            pool->push([&scheme, id = obj->id(), callback = std::move(callback)]() mutable
+            pool->push([&scheme, id = obj->id(), callback]() mutable
             {
-                std::apply(callback, scheme.search(id));
+                tao::apply(callback, scheme.search(id).downcast());
             }, counter);
         }
 
@@ -113,6 +115,38 @@ struct partial_scheme_view
 #endif
     }
 
+    // As `parallel`, but each job processes a contiguous slice of `grain` entities (0 to auto-tune)
+    template <typename traits, template <typename...> class S, typename C, typename... types>
+    inline static constexpr void parallel_chunked(np::counter& counter, np::fiber_pool<traits>* pool, S<types...>& scheme, C&& callback, uint32_t grain = 0) noexcept
+    {
+        static_assert(
+            (has_storage_tag(S<types...>::template orchestrator_t<components>::tag, storage_grow::none, storage_layout::continuous) && ...) ||
+            (has_storage_tag(S<types...>::template orchestrator_t<components>::tag, storage_grow::none, storage_layout::partitioned) && ...),
+            "Use parallel_by_chunked when the scheme contains mixed layouts"
+            );
+
+        view_detail::parallel_chunked<components...>(counter, pool, scheme, view_detail::all_entities{}, std::forward<C>(callback), grain);
+    }
+
+    template <typename By, typename traits, template <typename...> class S, typename C, typename... types>
+    inline static constexpr void parallel_by_chunked(np::counter& counter, np::fiber_pool<traits>* pool, S<types...>& scheme, C&& callback, uint32_t grain = 0) noexcept
+    {
+        view_detail::parallel_by_chunked<By, components...>(counter, pool, scheme, view_detail::all_entities{}, std::forward<C>(callback), grain);
+    }
+
+    // As `continuous_by`, but entities are resolved in blocks and their components prefetched
+    template <typename By, typename traits, template <typename...> class S, typename C, typename... types>
+    inline static constexpr void continuous_by_batched(np::counter& counter, np::fiber_pool<traits>* pool, S<types...>& scheme, C&& callback) noexcept
+    {
+        view_detail::continuous_by_batched<By, components...>(counter, pool, scheme, view_detail::all_entities{}, std::forward<C>(callback));
+    }
+
+    template <typename By, typename traits, template <typename...> class S, typename C, typename... types>
+    inline static constexpr void parallel_by_batched(np::counter& counter, np::fiber_pool<traits>* pool, S<types...>& scheme, C&& callback, uint32_t grain = 0) noexcept
+    {
+        view_detail::parallel_by_batched<By, components...>(counter, pool, scheme, view_detail::all_entities{}, std::forward<C>(callback), grain);
+    }
+
 private:
     partial_scheme_view();
 };
@@ -162,7 +196,7 @@ struct partial_scheme_view_until_partition
             auto& component = scheme.template get<By>();
             for (auto obj : component.range_until_partition())
             {
-                std::apply(callback, scheme.search(obj->id()));
+                tao::apply(callback, scheme.search(obj->id()).downcast());
             }
         }, counter);
 
@@ -189,7 +223,7 @@ struct partial_scheme_view_until_partition
 
         for (auto combined : ::ranges::views::zip(scheme.template get<components>().range_until_partition()...))
         {
-            pool->push([&scheme, combined, callback = std::move(callback)]() mutable
+            pool->push([&scheme, combined, callback]() mutable
             {
                 std::apply(callback, combined);
             }, counter);
@@ -202,7 +236,7 @@ struct partial_scheme_view_until_partition
 #endif
     }
 
-    template <typename By, typename traits, template <typename...> class S, typename O, typename C, typename... types>
+    template <typename By, typename traits, template <typename...> class S, typename C, typename... types>
     inline static constexpr void parallel_by(np::counter& counter, np::fiber_pool<traits>* pool, S<types...>& scheme, C&& callback) noexcept
     {
         if (scheme.size_until_partition() == 0)
@@ -213,9 +247,9 @@ struct partial_scheme_view_until_partition
         auto& component = scheme.template get<By>();
         for (auto obj : component.range_until_partition())
         {
-            pool->push([&scheme, id = obj->id(), callback = std::move(callback)]() mutable
+            pool->push([&scheme, id = obj->id(), callback]() mutable
             {
-                std::apply(callback, scheme.search(id));
+                tao::apply(callback, scheme.search(id).downcast());
             }, counter);
         }
 
@@ -226,6 +260,38 @@ struct partial_scheme_view_until_partition
 #endif
     }
 
+    // As `parallel`, but each job processes a contiguous slice of `grain` entities (0 to auto-tune)
+    template <typename traits, template <typename...> class S, typename C, typename... types>
+    inline static constexpr void parallel_chunked(np::counter& counter, np::fiber_pool<traits>* pool, S<types...>& scheme, C&& callback, uint32_t grain = 0) noexcept
+    {
+        static_assert(
+            (has_storage_tag(S<types...>::template orchestrator_t<components>::tag, storage_grow::none, storage_layout::continuous) && ...) ||
+            (has_storage_tag(S<types...>::template orchestrator_t<components>::tag, storage_grow::none, storage_layout::partitioned) && ...),
+            "Use parallel_by_chunked when the scheme contains mixed layouts"
+            );
+
+        view_detail::parallel_chunked<components...>(counter, pool, scheme, view_detail::until_partition{}, std::forward<C>(callback), grain);
+    }
+
+    template <typename By, typename traits, template <typename...> class S, typename C, typename... types>
+    inline static constexpr void parallel_by_chunked(np::counter& counter, np::fiber_pool<traits>* pool, S<types...>& scheme, C&& callback, uint32_t grain = 0) noexcept
+    {
+        view_detail::parallel_by_chunked<By, components...>(counter, pool, scheme, view_detail::until_partition{}, std::forward<C>(callback), grain);
+    }
+
+    // As `continuous_by`, but entities are resolved in blocks and their components prefetched
+    template <typename By, typename traits, template <typename...> class S, typename C, typename... types>
+    inline static constexpr void continuous_by_batched(np::counter& counter, np::fiber_pool<traits>* pool, S<types...>& scheme, C&& callback) noexcept
+    {
+        view_detail::continuous_by_batched<By, components...>(counter, pool, scheme, view_detail::until_partition{}, std::forward<C>(callback));
+    }
+
+    template <typename By, typename traits, template <typename...> class S, typename C, typename... types>
+    inline static constexpr void parallel_by_batched(np::counter& counter, np::fiber_pool<traits>* pool, S<types...>& scheme, C&& callback, uint32_t grain = 0) noexcept
+    {
+        view_detail::parallel_by_batched<By, components...>(counter, pool, scheme, view_detail::until_partition{}, std::forward<C>(callback), grain);
+    }
+
 private:
     partial_scheme_view_until_partition();
 };
@@ -275,7 +341,7 @@ struct partial_scheme_view_from_partition
             auto& component = scheme.template get<By>();
             for (auto obj : component.range_from_partition())
             {
-                std::apply(callback, scheme.search(obj->id()));
+                tao::apply(callback, scheme.search(obj->id()).downcast());
             }
         }, counter);
 
@@ -302,7 +368,7 @@ struct partial_scheme_view_from_partition
 
         for (auto combined : ::ranges::views::zip(scheme.template get<components>().range_from_partition()...))
         {
-            pool->push([&scheme, combined, callback = std::move(callback)]() mutable
+            pool->push([&scheme, combined, callback]() mutable
             {
                 std::apply(callback, combined);
             }, counter);
@@ -315,7 +381,7 @@ struct partial_scheme_view_from_partition
 #endif
     }
 
-    template <typename By, typename traits, template <typename...> class S, typename O, typename C, typename... types>
+    template <typename By, typename traits, template <typename...> class S, typename C, typename... types>
     inline static constexpr void parallel_by(np::counter& counter, np::fiber_pool<traits>* pool, S<types...>& scheme, C&& callback) noexcept
     {
         if (scheme.size_from_partition() == 0)
@@ -326,9 +392,9 @@ struct partial_scheme_view_from_partition
         auto& component = scheme.template get<By>();
         for (auto obj : component.range_from_partition())
         {
-            pool->push([&scheme, id = obj->id(), callback = std::move(callback)]() mutable
+            pool->push([&scheme, id = obj->id(), callback]() mutable
             {
-                std::apply(callback, scheme.search(id));
+                tao::apply(callback, scheme.search(id).downcast());
             }, counter);
         }
         
@@ -339,6 +405,38 @@ struct partial_scheme_view_from_partition
 #endif
     }
 
+    // As `parallel`, but each job processes a contiguous slice of `grain` entities (0 to auto-tune)
+    template <typename traits, template <typename...> class S, typename C, typename... types>
+    inline static constexpr void parallel_chunked(np::counter& counter, np::fiber_pool<traits>* pool, S<types...>& scheme, C&& callback, uint32_t grain = 0) noexcept
+    {
+        static_assert(
+            (has_storage_tag(S<types...>::template orchestrator_t<components>::tag, storage_grow::none, storage_layout::continuous) && ...) ||
+            (has_storage_tag(S<types...>::template orchestrator_t<components>::tag, storage_grow::none, storage_layout::partitioned) && ...),
+            "Use parallel_by_chunked when the scheme contains mixed layouts"
+            );
+
+        view_detail::parallel_chunked<components...>(counter, pool, scheme, view_detail::from_partition{}, std::forward<C>(callback), grain);
+    }
+
+    template <typename By, typename traits, template <typename...> class S, typename C, typename... types>
+    inline static constexpr void parallel_by_chunked(np::counter& counter, np::fiber_pool<traits>* pool, S<types...>& scheme, C&& callback, uint32_t grain = 0) noexcept
+    {
+        view_detail::parallel_by_chunked<By, components...>(counter, pool, scheme, view_detail::from_partition{}, std::forward<C>(callback), grain);
+    }
+
+    // As `continuous_by`, but entities are resolved in blocks and their components prefetched
+    template <typename By, typename traits, template <typename...> class S, typename C, typename... types>
+    inline static constexpr void continuous_by_batched(np::counter& counter, np::fiber_pool<traits>* pool, S<types...>& scheme, C&& callback) noexcept
+    {
+        view_detail::continuous_by_batched<By, components...>(counter, pool, scheme, view_detail::from_partition{}, std::forward<C>(callback));
+    }
+
+    template <typename By, typename traits, template <typename...> class S, typename C, typename... types>
+    inline static constexpr void parallel_by_batched(np::counter& counter, np::fiber_pool<traits>* pool, S<types...>& scheme, C&& callback, uint32_t grain = 0) noexcept
+    {
+        view_detail::parallel_by_batched<By, components...>(counter, pool, scheme, view_detail::from_partition{}, std::forward<C>(callback), grain);
+    }
+
 private:
     partial_scheme_view_from_partition();
 };
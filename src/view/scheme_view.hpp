@@ -3,6 +3,8 @@
 #include <synchronization/counter.hpp>
 #include <pool/fiber_pool.hpp>
 
+#include "view/scheme_view_detail.hpp"
+
 
 struct scheme_view
 {
@@ -11,7 +13,8 @@ struct scheme_view
     {
         static_assert(
             (has_storage_tag(types::tag, storage_grow::none, storage_layout::continuous) && ...) ||
-            (has_storage_tag(types::tag, storage_grow::none, storage_layout::partitioned) && ...),
+            (has_storage_tag(types::tag, storage_grow::none, storage_layout::partitioned) && ...) ||
+            (is_multi_partitioned_storage(types::tag) && ...),
             "Use continuous_by when the scheme contains mixed layouts"
         );
         
@@ -48,7 +51,7 @@ struct scheme_view
             auto& component = scheme.template get<By>();
             for (auto obj : component.range())
             {
-                std::apply(callback, scheme.search(obj->id()));
+                tao::apply(callback, scheme.search(obj->id()).downcast());
             }
         }, counter);
 
@@ -64,7 +67,8 @@ struct scheme_view
     {
         static_assert(
             (has_storage_tag(types::tag, storage_grow::none, storage_layout::continuous) && ...) ||
-            (has_storage_tag(types::tag, storage_grow::none, storage_layout::partitioned) && ...),
+            (has_storage_tag(types::tag, storage_grow::none, storage_layout::partitioned) && ...) ||
+            (is_multi_partitioned_storage(types::tag) && ...),
             "Use parallel_by when the scheme contains mixed layouts"
             );
 
@@ -75,7 +79,7 @@ struct scheme_view
 
         for (auto combined : ::ranges::views::zip(scheme.template get<types>().range()...))
         {
-            pool->push([&scheme, combined, callback = std::move(callback)]() mutable
+            pool->push([&scheme, combined, callback]() mutable
             {
                 std::apply(callback, combined);
             }, counter);
@@ -88,7 +92,7 @@ struct scheme_view
 #endif
     }
 
-    template <typename By, typename traits, template <typename...> class S, typename O, typename C, typename... types>
+    template <typename By, typename traits, template <typename...> class S, typename C, typename... types>
     inline static constexpr void parallel_by(np::counter& counter, np::fiber_pool<traits>* pool, S<types...>& scheme, C&& callback) noexcept
     {
         if (scheme.size() == 0)
@@ -99,9 +103,9 @@ struct scheme_view
         auto& component = scheme.template get<By>();
         for (auto obj : component.range())
         {
-            pool->push([&scheme, id = obj->id(), callback = std::move(callback)]() mutable
+            pool->push([&scheme, id = obj->id(), callback]() mutable
             {
-                std::apply(callback, scheme.search(id));
+                tao::apply(callback, scheme.search(id).downcast());
             }, counter);
         }
 
@@ -112,6 +116,39 @@ struct scheme_view
 #endif
     }
 
+    // As `parallel`, but each job processes a contiguous slice of `grain` entities (0 to auto-tune)
+    template <typename traits, template <typename...> class S, typename C, typename... types>
+    inline static constexpr void parallel_chunked(np::counter& counter, np::fiber_pool<traits>* pool, S<types...>& scheme, C&& callback, uint32_t grain = 0) noexcept
+    {
+        static_assert(
+            (has_storage_tag(types::tag, storage_grow::none, storage_layout::continuous) && ...) ||
+            (has_storage_tag(types::tag, storage_grow::none, storage_layout::partitioned) && ...) ||
+            (is_multi_partitioned_storage(types::tag) && ...),
+            "Use parallel_by_chunked when the scheme contains mixed layouts"
+            );
+
+        view_detail::parallel_chunked<types...>(counter, pool, scheme, view_detail::all_entities{}, std::forward<C>(callback), grain);
+    }
+
+    template <typename By, typename traits, template <typename...> class S, typename C, typename... types>
+    inline static constexpr void parallel_by_chunked(np::counter& counter, np::fiber_pool<traits>* pool, S<types...>& scheme, C&& callback, uint32_t grain = 0) noexcept
+    {
+        view_detail::parallel_by_chunked<By, types...>(counter, pool, scheme, view_detail::all_entities{}, std::forward<C>(callback), grain);
+    }
+
+    // As `continuous_by`, but entities are resolved in blocks and their components prefetched
+    template <typename By, typename traits, template <typename...> class S, typename C, typename... types>
+    inline static constexpr void continuous_by_batched(np::counter& counter, np::fiber_pool<traits>* pool, S<types...>& scheme, C&& callback) noexcept
+    {
+        view_detail::continuous_by_batched<By, types...>(counter, pool, scheme, view_detail::all_entities{}, std::forward<C>(callback));
+    }
+
+    template <typename By, typename traits, template <typename...> class S, typename C, typename... types>
+    inline static constexpr void parallel_by_batched(np::counter& counter, np::fiber_pool<traits>* pool, S<types...>& scheme, C&& callback, uint32_t grain = 0) noexcept
+    {
+        view_detail::parallel_by_batched<By, types...>(counter, pool, scheme, view_detail::all_entities{}, std::forward<C>(callback), grain);
+    }
+
 private:
     scheme_view();
 };
@@ -160,7 +197,7 @@ struct scheme_view_until_partition
             auto& component = scheme.template get<By>();
             for (auto obj : component.range_until_partition())
             {
-                std::apply(callback, scheme.search(obj->id()));
+                tao::apply(callback, scheme.search(obj->id()).downcast());
             }
         }, counter);
 
@@ -187,7 +224,7 @@ struct scheme_view_until_partition
 
         for (auto combined : ::ranges::views::zip(scheme.template get<types>().range_until_partition()...))
         {
-            pool->push([&scheme, combined, callback = std::move(callback)]() mutable
+            pool->push([&scheme, combined, callback]() mutable
             {
                 std::apply(callback, combined);
             }, counter);
@@ -200,7 +237,7 @@ struct scheme_view_until_partition
 #endif
     }
 
-    template <typename By, typename traits, template <typename...> class S, typename O, typename C, typename... types>
+    template <typename By, typename traits, template <typename...> class S, typename C, typename... types>
     inline static constexpr void parallel_by(np::counter& counter, np::fiber_pool<traits>* pool, S<types...>& scheme, C&& callback) noexcept
     {
         if (scheme.size_until_partition() == 0)
@@ -211,9 +248,9 @@ struct scheme_view_until_partition
         auto& component = scheme.template get<By>();
         for (auto obj : component.range_until_partition())
         {
-            pool->push([&scheme, id = obj->id(), callback = std::move(callback)]() mutable
+            pool->push([&scheme, id = obj->id(), callback]() mutable
             {
-                std::apply(callback, scheme.search(id));
+                tao::apply(callback, scheme.search(id).downcast());
             }, counter);
         }
 
@@ -224,6 +261,38 @@ struct scheme_view_until_partition
 #endif
     }
 
+    // As `parallel`, but each job processes a contiguous slice of `grain` entities (0 to auto-tune)
+    template <typename traits, template <typename...> class S, typename C, typename... types>
+    inline static constexpr void parallel_chunked(np::counter& counter, np::fiber_pool<traits>* pool, S<types...>& scheme, C&& callback, uint32_t grain = 0) noexcept
+    {
+        static_assert(
+            (has_storage_tag(types::tag, storage_grow::none, storage_layout::continuous) && ...) ||
+            (has_storage_tag(types::tag, storage_grow::none, storage_layout::partitioned) && ...),
+            "Use parallel_by_chunked when the scheme contains mixed layouts"
+            );
+
+        view_detail::parallel_chunked<types...>(counter, pool, scheme, view_detail::until_partition{}, std::forward<C>(callback), grain);
+    }
+
+    template <typename By, typename traits, template <typename...> class S, typename C, typename... types>
+    inline static constexpr void parallel_by_chunked(np::counter& counter, np::fiber_pool<traits>* pool, S<types...>& scheme, C&& callback, uint32_t grain = 0) noexcept
+    {
+        view_detail::parallel_by_chunked<By, types...>(counter, pool, scheme, view_detail::until_partition{}, std::forward<C>(callback), grain);
+    }
+
+    // As `continuous_by`, but entities are resolved in blocks and their components prefetched
+    template <typename By, typename traits, template <typename...> class S, typename C, typename... types>
+    inline static constexpr void continuous_by_batched(np::counter& counter, np::fiber_pool<traits>* pool, S<types...>& scheme, C&& callback) noexcept
+    {
+        view_detail::continuous_by_batched<By, types...>(counter, pool, scheme, view_detail::until_partition{}, std::forward<C>(callback));
+    }
+
+    template <typename By, typename traits, template <typename...> class S, typename C, typename... types>
+    inline static constexpr void parallel_by_batched(np::counter& counter, np::fiber_pool<traits>* pool, S<types...>& scheme, C&& callback, uint32_t grain = 0) noexcept
+    {
+        view_detail::parallel_by_batched<By, types...>(counter, pool, scheme, view_detail::until_partition{}, std::forward<C>(callback), grain);
+    }
+
 private:
     scheme_view_until_partition();
 };
@@ -272,7 +341,7 @@ struct scheme_view_from_partition
             auto& component = scheme.template get<By>();
             for (auto obj : component.range_from_partition())
             {
-                std::apply(callback, scheme.search(obj->id()));
+                tao::apply(callback, scheme.search(obj->id()).downcast());
             }
         }, counter);
 
@@ -299,7 +368,7 @@ struct scheme_view_from_partition
 
         for (auto combined : ::ranges::views::zip(scheme.template get<types>().range_from_partition()...))
         {
-            pool->push([&scheme, combined, callback = std::move(callback)]() mutable
+            pool->push([&scheme, combined, callback]() mutable
             {
                 std::apply(callback, combined);
             }, counter);
@@ -312,7 +381,7 @@ struct scheme_view_from_partition
 #endif
     }
 
-    template <typename By, typename traits, template <typename...> class S, typename O, typename C, typename... types>
+    template <typename By, typename traits, template <typename...> class S, typename C, typename... types>
     inline static constexpr void parallel_by(np::counter& counter, np::fiber_pool<traits>* pool, S<types...>& scheme, C&& callback) noexcept
     {
         if (scheme.size_from_partition() == 0)
@@ -323,9 +392,9 @@ struct scheme_view_from_partition
         auto& component = scheme.template get<By>();
         for (auto obj : component.range_from_partition())
         {
-            pool->push([&scheme, id = obj->id(), callback = std::move(callback)]() mutable
+            pool->push([&scheme, id = obj->id(), callback]() mutable
             {
-                std::apply(callback, scheme.search(id));
+                tao::apply(callback, scheme.search(id).downcast());
             }, counter);
         }
         
@@ -336,6 +405,181 @@ struct scheme_view_from_partition
 #endif
     }
 
+    // As `parallel`, but each job processes a contiguous slice of `grain` entities (0 to auto-tune)
+    template <typename traits, template <typename...> class S, typename C, typename... types>
+    inline static constexpr void parallel_chunked(np::counter& counter, np::fiber_pool<traits>* pool, S<types...>& scheme, C&& callback, uint32_t grain = 0) noexcept
+    {
+        static_assert(
+            (has_storage_tag(types::tag, storage_grow::none, storage_layout::continuous) && ...) ||
+            (has_storage_tag(types::tag, storage_grow::none, storage_layout::partitioned) && ...),
+            "Use parallel_by_chunked when the scheme contains mixed layouts"
+            );
+
+        view_detail::parallel_chunked<types...>(counter, pool, scheme, view_detail::from_partition{}, std::forward<C>(callback), grain);
+    }
+
+    template <typename By, typename traits, template <typename...> class S, typename C, typename... types>
+    inline static constexpr void parallel_by_chunked(np::counter& counter, np::fiber_pool<traits>* pool, S<types...>& scheme, C&& callback, uint32_t grain = 0) noexcept
+    {
+        view_detail::parallel_by_chunked<By, types...>(counter, pool, scheme, view_detail::from_partition{}, std::forward<C>(callback), grain);
+    }
+
+    // As `continuous_by`, but entities are resolved in blocks and their components prefetched
+    template <typename By, typename traits, template <typename...> class S, typename C, typename... types>
+    inline static constexpr void continuous_by_batched(np::counter& counter, np::fiber_pool<traits>* pool, S<types...>& scheme, C&& callback) noexcept
+    {
+        view_detail::continuous_by_batched<By, types...>(counter, pool, scheme, view_detail::from_partition{}, std::forward<C>(callback));
+    }
+
+    template <typename By, typename traits, template <typename...> class S, typename C, typename... types>
+    inline static constexpr void parallel_by_batched(np::counter& counter, np::fiber_pool<traits>* pool, S<types...>& scheme, C&& callback, uint32_t grain = 0) noexcept
+    {
+        view_detail::parallel_by_batched<By, types...>(counter, pool, scheme, view_detail::from_partition{}, std::forward<C>(callback), grain);
+    }
+
 private:
     scheme_view_from_partition();
 };
+
+// Views over a single partition of schemes whose storages are all multi-partitioned, so that each
+//  partition can be updated at its own rate
+struct scheme_view_partition
+{
+    template <typename traits, template <typename...> class S, typename C, typename... types>
+    inline static constexpr void continuous(np::counter& counter, np::fiber_pool<traits>* pool, S<types...>& scheme, uint8_t partition, C&& callback) noexcept
+    {
+        static_assert(
+            (is_multi_partitioned_storage(types::tag) && ...),
+            "Use continuous_by when the scheme contains mixed layouts"
+            );
+
+        if (scheme.size(partition) == 0)
+        {
+            return;
+        }
+
+        pool->push([&scheme, partition, callback = std::move(callback)]()
+        {
+            for (auto combined : ::ranges::views::zip(scheme.template get<types>().range(partition)...))
+            {
+                std::apply(callback, combined);
+            }
+        }, counter);
+
+#if !defined(NDEBUG)
+        counter.on_wait_done([&scheme]() {
+            (..., scheme.template get<types>().unlock_writes());
+            });
+#endif
+    }
+
+    template <typename By, typename traits, template <typename...> class S, typename C, typename... types>
+    inline static constexpr void continuous_by(np::counter& counter, np::fiber_pool<traits>* pool, S<types...>& scheme, uint8_t partition, C&& callback) noexcept
+    {
+        if (scheme.size(partition) == 0)
+        {
+            return;
+        }
+
+        pool->push([&scheme, partition, callback = std::move(callback)]()
+        {
+            auto& component = scheme.template get<By>();
+            for (auto obj : component.range(partition))
+            {
+                tao::apply(callback, scheme.search(obj->id()).downcast());
+            }
+        }, counter);
+
+#if !defined(NDEBUG)
+        counter.on_wait_done([&scheme]() {
+            (..., scheme.template get<types>().unlock_writes());
+            });
+#endif
+    }
+
+    template <typename traits, template <typename...> class S, typename C, typename... types>
+    inline static constexpr void parallel(np::counter& counter, np::fiber_pool<traits>* pool, S<types...>& scheme, uint8_t partition, C&& callback) noexcept
+    {
+        static_assert(
+            (is_multi_partitioned_storage(types::tag) && ...),
+            "Use parallel_by when the scheme contains mixed layouts"
+            );
+
+        if (scheme.size(partition) == 0)
+        {
+            return;
+        }
+
+        for (auto combined : ::ranges::views::zip(scheme.template get<types>().range(partition)...))
+        {
+            pool->push([&scheme, combined, callback]() mutable
+            {
+                std::apply(callback, combined);
+            }, counter);
+        }
+
+#if !defined(NDEBUG)
+        counter.on_wait_done([&scheme]() {
+            (..., scheme.template get<types>().unlock_writes());
+            });
+#endif
+    }
+
+    template <typename By, typename traits, template <typename...> class S, typename C, typename... types>
+    inline static constexpr void parallel_by(np::counter& counter, np::fiber_pool<traits>* pool, S<types...>& scheme, uint8_t partition, C&& callback) noexcept
+    {
+        if (scheme.size(partition) == 0)
+        {
+            return;
+        }
+
+        auto& component = scheme.template get<By>();
+        for (auto obj : component.range(partition))
+        {
+            pool->push([&scheme, id = obj->id(), callback]() mutable
+            {
+                tao::apply(callback, scheme.search(id).downcast());
+            }, counter);
+        }
+
+#if !defined(NDEBUG)
+        counter.on_wait_done([&scheme]() {
+            (..., scheme.template get<types>().unlock_writes());
+            });
+#endif
+    }
+
+    // As `parallel`, but each job processes a contiguous slice of `grain` entities (0 to auto-tune)
+    template <typename traits, template <typename...> class S, typename C, typename... types>
+    inline static constexpr void parallel_chunked(np::counter& counter, np::fiber_pool<traits>* pool, S<types...>& scheme, uint8_t partition, C&& callback, uint32_t grain = 0) noexcept
+    {
+        static_assert(
+            (is_multi_partitioned_storage(types::tag) && ...),
+            "Use parallel_by_chunked when the scheme contains mixed layouts"
+            );
+
+        view_detail::parallel_chunked<types...>(counter, pool, scheme, view_detail::single_partition{ partition }, std::forward<C>(callback), grain);
+    }
+
+    template <typename By, typename traits, template <typename...> class S, typename C, typename... types>
+    inline static constexpr void parallel_by_chunked(np::counter& counter, np::fiber_pool<traits>* pool, S<types...>& scheme, uint8_t partition, C&& callback, uint32_t grain = 0) noexcept
+    {
+        view_detail::parallel_by_chunked<By, types...>(counter, pool, scheme, view_detail::single_partition{ partition }, std::forward<C>(callback), grain);
+    }
+
+    // As `continuous_by`, but entities are resolved in blocks and their components prefetched
+    template <typename By, typename traits, template <typename...> class S, typename C, typename... types>
+    inline static constexpr void continuous_by_batched(np::counter& counter, np::fiber_pool<traits>* pool, S<types...>& scheme, uint8_t partition, C&& callback) noexcept
+    {
+        view_detail::continuous_by_batched<By, types...>(counter, pool, scheme, view_detail::single_partition{ partition }, std::forward<C>(callback));
+    }
+
+    template <typename By, typename traits, template <typename...> class S, typename C, typename... types>
+    inline static constexpr void parallel_by_batched(np::counter& counter, np::fiber_pool<traits>* pool, S<types...>& scheme, uint8_t partition, C&& callback, uint32_t grain = 0) noexcept
+    {
+        view_detail::parallel_by_batched<By, types...>(counter, pool, scheme, view_detail::single_partition{ partition }, std::forward<C>(callback), grain);
+    }
+
+private:
+    scheme_view_partition();
+};
@@ -0,0 +1,127 @@
+#pragma once
+
+#include <synchronization/counter.hpp>
+#include <pool/fiber_pool.hpp>
+
+#include "view/batched_search.hpp"
+#include "view/view_slices.hpp"
+
+#include <inttypes.h>
+#include <tuple>
+
+
+// Chunked and batched view bodies, shared by `scheme_view`, `partial_scheme_view` and their partition
+// variants. Each body takes the components to walk and unlock, and a selection of which of their
+// entities to walk, thus the view structs only forward to them
+namespace view_detail
+{
+    struct all_entities
+    {
+        template <typename S> inline std::size_t size(S& scheme) const noexcept { return scheme.size(); }
+        template <typename O> inline auto spans(O& orchestrator) const noexcept { return orchestrator.spans(); }
+    };
+
+    struct until_partition
+    {
+        template <typename S> inline std::size_t size(S& scheme) const noexcept { return scheme.size_until_partition(); }
+        template <typename O> inline auto spans(O& orchestrator) const noexcept { return orchestrator.spans_until_partition(); }
+    };
+
+    struct from_partition
+    {
+        template <typename S> inline std::size_t size(S& scheme) const noexcept { return scheme.size_from_partition(); }
+        template <typename O> inline auto spans(O& orchestrator) const noexcept { return orchestrator.spans_from_partition(); }
+    };
+
+    struct single_partition
+    {
+        uint8_t partition;
+
+        template <typename S> inline std::size_t size(S& scheme) const noexcept { return scheme.size(partition); }
+        template <typename O> inline auto spans(O& orchestrator) const noexcept { return orchestrator.spans(partition); }
+    };
+
+    template <typename... components, typename traits, typename S, typename E, typename C>
+    inline void parallel_chunked(np::counter& counter, np::fiber_pool<traits>* pool, S& scheme, E selection, C&& callback, uint32_t grain) noexcept
+    {
+        if (selection.size(scheme) == 0)
+        {
+            return;
+        }
+
+        push_slice_jobs(counter, pool, selection.size(scheme), grain,
+            [&scheme, selection, callback = std::forward<C>(callback)](std::size_t begin, std::size_t count) mutable
+            {
+                for_each_zipped(begin, count, callback, selection.spans(scheme.template get<components>())...);
+            });
+
+#if !defined(NDEBUG)
+        counter.on_wait_done([&scheme]() {
+            (..., scheme.template get<components>().unlock_writes());
+            });
+#endif
+    }
+
+    template <typename By, typename... components, typename traits, typename S, typename E, typename C>
+    inline void parallel_by_chunked(np::counter& counter, np::fiber_pool<traits>* pool, S& scheme, E selection, C&& callback, uint32_t grain) noexcept
+    {
+        if (selection.size(scheme) == 0)
+        {
+            return;
+        }
+
+        push_slice_jobs(counter, pool, selection.size(scheme), grain,
+            [&scheme, selection, callback = std::forward<C>(callback)](std::size_t begin, std::size_t count) mutable
+            {
+                auto by_id = [&scheme, &callback](auto obj) { tao::apply(callback, scheme.search(obj->id()).downcast()); };
+                for_each_zipped(begin, count, by_id, selection.spans(scheme.template get<By>()));
+            });
+
+#if !defined(NDEBUG)
+        counter.on_wait_done([&scheme]() {
+            (..., scheme.template get<components>().unlock_writes());
+            });
+#endif
+    }
+
+    template <typename By, typename... components, typename traits, typename S, typename E, typename C>
+    inline void continuous_by_batched(np::counter& counter, np::fiber_pool<traits>* pool, S& scheme, E selection, C&& callback) noexcept
+    {
+        if (selection.size(scheme) == 0)
+        {
+            return;
+        }
+
+        pool->push([&scheme, selection, callback = std::forward<C>(callback)]() mutable
+        {
+            for_each_batched(scheme, span_cursor(selection.spans(scheme.template get<By>()), 0), selection.size(scheme), callback);
+        }, counter);
+
+#if !defined(NDEBUG)
+        counter.on_wait_done([&scheme]() {
+            (..., scheme.template get<components>().unlock_writes());
+            });
+#endif
+    }
+
+    template <typename By, typename... components, typename traits, typename S, typename E, typename C>
+    inline void parallel_by_batched(np::counter& counter, np::fiber_pool<traits>* pool, S& scheme, E selection, C&& callback, uint32_t grain) noexcept
+    {
+        if (selection.size(scheme) == 0)
+        {
+            return;
+        }
+
+        push_slice_jobs(counter, pool, selection.size(scheme), grain,
+            [&scheme, selection, callback = std::forward<C>(callback)](std::size_t begin, std::size_t count) mutable
+            {
+                for_each_batched(scheme, span_cursor(selection.spans(scheme.template get<By>()), begin), count, callback);
+            });
+
+#if !defined(NDEBUG)
+        counter.on_wait_done([&scheme]() {
+            (..., scheme.template get<components>().unlock_writes());
+            });
+#endif
+    }
+}
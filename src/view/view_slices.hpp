@@ -0,0 +1,101 @@
+#pragma once
+
+#include <synchronization/counter.hpp>
+#include <pool/fiber_pool.hpp>
+
+#include <range/v3/range/access.hpp>
+
+#include <algorithm>
+#include <inttypes.h>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+
+
+namespace view_detail
+{
+    // Slices smaller than this cost more to schedule than to run
+    inline constexpr uint32_t minimum_grain = 64;
+    inline constexpr uint32_t slices_per_worker = 4;
+
+    template <typename traits>
+    inline uint32_t grain_size(np::fiber_pool<traits>* pool, std::size_t size, uint32_t grain) noexcept
+    {
+        if (grain != 0)
+        {
+            return grain;
+        }
+
+        // Auto-tune: a few slices per worker, so that uneven slices can still be balanced
+        const std::size_t workers = std::max<std::size_t>(pool->maximum_worker_id(), 1);
+        return static_cast<uint32_t>(std::max<std::size_t>(size / (workers * slices_per_worker), minimum_grain));
+    }
+
+    // Walks the elements of a list of spans (ie. `spans()`) from any position on, yielding pointers to them
+    // as `range()` does. Ranges over paged or concatenated storages are not random access, whereas spans
+    // let it reach a position by skipping whole spans
+    template <typename R>
+    class span_cursor
+    {
+        using span_t = std::decay_t<decltype(*::ranges::begin(std::declval<R&>()))>;
+
+    public:
+        span_cursor(R spans, std::size_t position) noexcept :
+            _spans(std::move(spans)),
+            _span(0),
+            _current(*::ranges::begin(_spans)),
+            _offset(position)
+        {}
+
+        inline auto operator*() noexcept
+        {
+            // Lazily, so that a cursor past the last element never reads beyond the last span
+            while (_offset >= _current.size())
+            {
+                _offset -= _current.size();
+                _current = ::ranges::begin(_spans)[++_span];
+            }
+
+            return &_current[_offset];
+        }
+
+        inline span_cursor& operator++() noexcept
+        {
+            ++_offset;
+            return *this;
+        }
+
+    private:
+        R _spans;
+        std::size_t _span;
+        span_t _current;
+        std::size_t _offset;
+    };
+
+    // Invokes `callback` with the elements at `[begin, begin + count)` of every list of spans, side by side
+    template <typename C, typename... R>
+    inline void for_each_zipped(std::size_t begin, std::size_t count, C& callback, R&&... spans) noexcept
+    {
+        auto cursors = std::make_tuple(span_cursor<std::decay_t<R>>(std::forward<R>(spans), begin)...);
+        for (std::size_t idx = 0; idx < count; ++idx)
+        {
+            std::apply([&callback](auto&... cursor) { callback(*cursor...); (++cursor, ...); }, cursors);
+        }
+    }
+
+    // Pushes one job per contiguous slice of `size` elements, calling `process_slice(begin, count)`. Views are
+    // cheap, non-owning, and iterators may point into them, thus each job rebuilds whatever it walks
+    template <typename traits, typename F>
+    inline void push_slice_jobs(np::counter& counter, np::fiber_pool<traits>* pool, std::size_t size, uint32_t grain, F&& process_slice) noexcept
+    {
+        grain = grain_size(pool, size, grain);
+
+        for (std::size_t begin = 0; begin < size; begin += grain)
+        {
+            pool->push([process_slice, begin, count = std::min<std::size_t>(grain, size - begin)]() mutable
+            {
+                process_slice(begin, count);
+            }, counter);
+        }
+    }
+}
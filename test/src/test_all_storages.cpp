@@ -1,11 +1,16 @@
 #include <catch2/catch_all.hpp>
+#include <numeric>
 #include <random>
 
 #include <entity/component.hpp>
 #include <entity/scheme.hpp>
 #include <storage/growable_storage.hpp>
+#include <storage/multi_partitioned_storage.hpp>
+#include <storage/paged_growable_storage.hpp>
 #include <storage/partitioned_growable_storage.hpp>
+#include <storage/sparse_set_index.hpp>
 #include <storage/partitioned_static_storage.hpp>
+#include <storage/soa_storage.hpp>
 #include <storage/static_growable_storage.hpp>
 #include <storage/static_storage.hpp>
 
@@ -29,6 +34,27 @@ private:
     bool _partition;
 };
 
+// Same as `client`, but keeping some fields out of the component in SoA storages
+class soa_client : public component<soa_client>
+{
+public:
+    using component<soa_client>::component;
+    using soa_fields = std::tuple<float, uint64_t>;
+
+    inline void construct(bool partition)
+    {
+        _partition = partition;
+    }
+
+    inline bool partition() const
+    {
+        return _partition;
+    }
+
+private:
+    bool _partition;
+};
+
 constexpr uint32_t initial_size = 100;
 constexpr uint32_t random_splits = 10;
 
@@ -66,11 +92,11 @@ inline void push_random_partition_if_available(S& storage, uint64_t id)
     }
 }
 
-template <template <typename, uint32_t> typename T>
+template <template <typename, uint32_t> typename T, template <typename> typename I = map_index, typename C = client>
 inline void generate_test_cases()
 {
-    using storage_t = T<client, initial_size>;
-    using orchestrator_t = orchestrator<T, client, initial_size>;
+    using storage_t = T<C, initial_size>;
+    using orchestrator_t = orchestrator<T, C, initial_size, I>;
 
     GIVEN("The bare storage " + std::string(typeid(storage_t).name()))
     {
@@ -461,6 +487,53 @@ inline void generate_test_cases()
                     }
                 }
 
+                THEN("Spans yield the same elements as the range, in order")
+                {
+                    std::vector<uint64_t> range_ids;
+                    for (auto obj : orchestrator.range())
+                    {
+                        range_ids.push_back(obj->id());
+                    }
+
+                    std::vector<uint64_t> span_ids;
+                    for (auto span : orchestrator.spans())
+                    {
+                        for (auto& obj : span)
+                        {
+                            span_ids.push_back(obj.id());
+                        }
+                    }
+
+                    REQUIRE(range_ids == span_ids);
+                }
+
+                if constexpr (has_storage_tag(orchestrator_t::tag, storage_grow::none, storage_layout::partitioned))
+                {
+                    THEN("Partition spans contain elements of only its own partition")
+                    {
+                        int count = 0;
+                        for (auto span : orchestrator.spans_until_partition())
+                        {
+                            for (auto& obj : span)
+                            {
+                                REQUIRE(obj.partition());
+                                ++count;
+                            }
+                        }
+
+                        for (auto span : orchestrator.spans_from_partition())
+                        {
+                            for (auto& obj : span)
+                            {
+                                REQUIRE(!obj.partition());
+                                ++count;
+                            }
+                        }
+
+                        REQUIRE(count == orchestrator.size());
+                    }
+                }
+
                 if constexpr (has_storage_tag(orchestrator_t::tag, storage_grow::none, storage_layout::partitioned))
                 {
                     THEN("Both partitions summed contain the total amount of elements")
@@ -501,8 +574,543 @@ inline void generate_test_cases()
 SCENARIO("Tests all storages types", "[storage]")
 {
     generate_test_cases<growable_storage>();
+    generate_test_cases<paged_growable_storage>();
     generate_test_cases<partitioned_growable_storage>();
     generate_test_cases<partitioned_static_storage>();
+    generate_test_cases<soa_storage, map_index, soa_client>();
     generate_test_cases<static_growable_storage>();
     generate_test_cases<static_storage>();
 }
+
+SCENARIO("Tests all storages types with a sparse set index", "[storage]")
+{
+    generate_test_cases<growable_storage, sparse_set_index>();
+    generate_test_cases<paged_growable_storage, sparse_set_index>();
+    generate_test_cases<partitioned_growable_storage, sparse_set_index>();
+    generate_test_cases<partitioned_static_storage, sparse_set_index>();
+    generate_test_cases<soa_storage, sparse_set_index, soa_client>();
+    generate_test_cases<static_growable_storage, sparse_set_index>();
+    generate_test_cases<static_storage, sparse_set_index>();
+}
+
+// Slim components narrow ids to 32 bits, which the page table always covers
+#if !defined(UMI_SLIM_COMPONENTS)
+SCENARIO("Sparse set indices handle ids beyond their page table", "[storage]")
+{
+    GIVEN("An orchestrator with a sparse set index")
+    {
+        orchestrator<growable_storage, client, initial_size, sparse_set_index> orchestrator;
+        constexpr uint64_t large = sparse_set_index<client>::max_id + 1;
+
+        WHEN("Small and large ids are pushed")
+        {
+            for (uint64_t id = 0; id < 10; ++id)
+            {
+                orchestrator.push(id);
+                orchestrator.push(large + id * 4096);
+            }
+
+            THEN("All of them can be found")
+            {
+                for (uint64_t id = 0; id < 10; ++id)
+                {
+                    REQUIRE(orchestrator.get(id)->id() == id);
+                    REQUIRE(orchestrator.get(large + id * 4096)->id() == large + id * 4096);
+                }
+
+                REQUIRE(orchestrator.get(large + 1) == nullptr);
+            }
+
+            THEN("Lookups of present, missing and large ids can be prefetched")
+            {
+                for (uint64_t id : { uint64_t(3), uint64_t(1) << 20, large, large + 1 })
+                {
+                    orchestrator.prefetch(id);
+                    orchestrator.prefetch_entry(id);
+                }
+
+                REQUIRE(orchestrator.get(3)->id() == 3);
+                REQUIRE(orchestrator.get(uint64_t(1) << 20) == nullptr);
+                REQUIRE(orchestrator.get(large)->id() == large);
+            }
+
+            THEN("Large ids can be popped, leaving the rest untouched")
+            {
+                for (uint64_t id = 0; id < 10; id += 2)
+                {
+                    orchestrator.pop(orchestrator.get(large + id * 4096));
+                }
+
+                REQUIRE(orchestrator.size() == 15);
+                for (uint64_t id = 0; id < 10; ++id)
+                {
+                    REQUIRE(orchestrator.get(id)->id() == id);
+                    REQUIRE((orchestrator.get(large + id * 4096) == nullptr) == (id % 2 == 0));
+                }
+            }
+        }
+    }
+}
+#endif
+
+template <template <typename, uint32_t> typename T, typename C = client>
+inline void generate_batch_test_cases()
+{
+    using orchestrator_t = orchestrator<T, C, initial_size>;
+
+    GIVEN("An orchestrator over " + std::string(typeid(T<C, initial_size>).name()) + " with some items")
+    {
+        orchestrator_t orchestrator;
+        for (uint64_t id = 0; id < 10; ++id)
+        {
+            push_random_partition_if_available(orchestrator, id);
+        }
+
+        std::vector<uint64_t> ids(50);
+        std::iota(ids.begin(), ids.end(), 10);
+
+        std::vector<C*> out(ids.size());
+        if constexpr (is_partitioned_storage(orchestrator_t::tag))
+        {
+            orchestrator.push_n(out, true, ids, true);
+        }
+        else
+        {
+            orchestrator.push_n(out, ids);
+        }
+
+        auto check_partition = [&orchestrator]() {
+            if constexpr (is_partitioned_storage(orchestrator_t::tag))
+            {
+                for (auto x : orchestrator.range_until_partition())
+                {
+                    REQUIRE(x->partition());
+                }
+
+                for (auto x : orchestrator.range_from_partition())
+                {
+                    REQUIRE(!x->partition());
+                }
+
+#if !defined(NDEBUG)
+                orchestrator.unlock_writes();
+#endif
+            }
+        };
+
+        WHEN("A batch of items is pushed")
+        {
+            THEN("Every item is constructed, indexed and ticketed in order")
+            {
+                REQUIRE(orchestrator.size() == 60);
+                for (std::size_t idx = 0; idx < ids.size(); ++idx)
+                {
+                    REQUIRE(out[idx]->id() == ids[idx]);
+                    REQUIRE(orchestrator.get(ids[idx]) == out[idx]);
+                    REQUIRE(out[idx]->ticket()->get() == out[idx]);
+                }
+
+                for (uint64_t id = 0; id < 10; ++id)
+                {
+                    REQUIRE(orchestrator.get(id)->id() == id);
+                }
+
+                check_partition();
+            }
+        }
+
+        WHEN("A batch of items is popped")
+        {
+            std::vector<C*> popped;
+            for (uint64_t id = 0; id < 60; id += 3)
+            {
+                popped.push_back(orchestrator.get(id));
+            }
+
+            auto order = popped;
+            orchestrator.pop_n(popped);
+
+            THEN("The given list is only reordered in place")
+            {
+                std::sort(order.begin(), order.end());
+                std::sort(popped.begin(), popped.end());
+                REQUIRE(popped == order);
+            }
+
+            THEN("Only the remaining items can be found")
+            {
+                REQUIRE(orchestrator.size() == 40);
+                for (uint64_t id = 0; id < 60; ++id)
+                {
+                    if (id % 3 == 0)
+                    {
+                        REQUIRE(orchestrator.get(id) == nullptr);
+                    }
+                    else
+                    {
+                        REQUIRE(orchestrator.get(id)->id() == id);
+                    }
+                }
+
+                check_partition();
+            }
+        }
+    }
+}
+
+SCENARIO("Storages can push and pop in batches", "[storage]")
+{
+    generate_batch_test_cases<growable_storage>();
+    generate_batch_test_cases<paged_growable_storage>();
+    generate_batch_test_cases<partitioned_growable_storage>();
+    generate_batch_test_cases<partitioned_static_storage>();
+    generate_batch_test_cases<soa_storage, soa_client>();
+    generate_batch_test_cases<static_growable_storage>();
+    generate_batch_test_cases<static_storage>();
+}
+
+class counted_client : public component<counted_client>
+{
+public:
+    using component<counted_client>::component;
+
+    counted_client() noexcept { ++alive; }
+    counted_client(counted_client&& other) noexcept : component<counted_client>(std::move(other)) { ++alive; }
+    counted_client& operator=(counted_client&& other) noexcept = default;
+    ~counted_client() noexcept { --alive; }
+
+    inline void construct(bool partition) {}
+
+    static inline int alive = 0;
+};
+
+template <template <typename, uint32_t> typename T>
+inline void generate_lifetime_test_cases()
+{
+    using storage_t = T<counted_client, initial_size>;
+
+    GIVEN("The fixed storage " + std::string(typeid(storage_t).name()))
+    {
+        counted_client::alive = 0;
+        auto storage = std::make_unique<storage_t>();
+
+        THEN("No element is constructed upfront")
+        {
+            REQUIRE(counted_client::alive == 0);
+        }
+
+        WHEN("Some items are pushed and popped")
+        {
+            for (uint64_t id = 0; id < 10; ++id)
+            {
+                push_simple(*storage, id * 2);
+            }
+
+            const int pushed = storage->size();
+            storage->pop(*storage->range().begin());
+
+            THEN("Only live elements exist")
+            {
+                REQUIRE(counted_client::alive == pushed - 1);
+                REQUIRE(counted_client::alive == storage->size());
+            }
+
+            THEN("Destroying the storage destroys every element")
+            {
+                storage.reset();
+                REQUIRE(counted_client::alive == 0);
+            }
+        }
+    }
+}
+
+SCENARIO("Fixed storages construct elements lazily", "[storage]")
+{
+    generate_lifetime_test_cases<partitioned_static_storage>();
+    generate_lifetime_test_cases<static_growable_storage>();
+    generate_lifetime_test_cases<static_storage>();
+}
+
+SCENARIO("Partitioned static storages can move elements out of the partition", "[storage]")
+{
+    GIVEN("A partitioned static storage with elements in both partitions")
+    {
+        partitioned_static_storage<client, initial_size> storage;
+        auto first = storage.push(true, 0, true);
+        storage.push(true, 1, true);
+        storage.push(false, 2, false);
+
+        WHEN("The first element leaves the partition")
+        {
+            auto ticket = first->ticket();
+            auto moved = storage.change_partition(false, first);
+
+            THEN("Partition sizes are updated")
+            {
+                REQUIRE(storage.size_until_partition() == 1);
+                REQUIRE(storage.size_from_partition() == 2);
+            }
+
+            THEN("The ticket follows the element")
+            {
+                REQUIRE(ticket->get()->derived() == moved);
+                REQUIRE(moved->id() == 0);
+                REQUIRE(!storage.partition(moved));
+            }
+        }
+    }
+}
+
+SCENARIO("Paged storages never relocate elements when growing", "[storage]")
+{
+    GIVEN("A paged storage with a full first page")
+    {
+        paged_growable_storage<client, initial_size> storage;
+        std::vector<client*> pointers;
+        for (uint64_t id = 0; id < initial_size; ++id)
+        {
+            pointers.push_back(storage.push(id));
+        }
+
+        WHEN("It grows over several pages")
+        {
+            for (uint64_t id = initial_size; id < initial_size * 4; ++id)
+            {
+                storage.push(id);
+            }
+
+            THEN("Previous elements stay at the same address")
+            {
+                for (uint64_t id = 0; id < initial_size; ++id)
+                {
+                    REQUIRE(pointers[id]->id() == id);
+                }
+            }
+
+            THEN("Iteration visits every element in push order")
+            {
+                uint64_t id = 0;
+                for (auto x : storage.range())
+                {
+                    REQUIRE(x->id() == id++);
+                }
+                REQUIRE(id == initial_size * 4);
+            }
+        }
+    }
+}
+
+SCENARIO("SoA storages keep fields in lockstep with their components", "[storage]")
+{
+    using orchestrator_t = orchestrator<soa_storage, soa_client, initial_size>;
+
+    GIVEN("An SoA orchestrator where each entity stores its id in a field")
+    {
+        orchestrator_t orchestrator;
+        for (uint64_t id = 0; id < initial_size * 3; ++id)
+        {
+            auto obj = orchestrator.push(id);
+            orchestrator.field<0>(obj) = static_cast<float>(id);
+            orchestrator.field<1>(obj) = id;
+        }
+
+        THEN("Field columns are aligned to a cache line")
+        {
+            REQUIRE(reinterpret_cast<std::uintptr_t>(orchestrator.field<0>().data()) % 64 == 0);
+            REQUIRE(reinterpret_cast<std::uintptr_t>(orchestrator.field<1>().data()) % 64 == 0);
+#if !defined(NDEBUG)
+            orchestrator.unlock_writes();
+#endif
+        }
+
+        WHEN("Half of the entities are popped")
+        {
+            for (uint64_t id = 0; id < initial_size * 3; id += 2)
+            {
+                orchestrator.pop(orchestrator.get(id));
+            }
+
+            THEN("Each field still belongs to its component")
+            {
+                auto ids = orchestrator.field<1>();
+                uint32_t idx = 0;
+                for (auto obj : orchestrator.range())
+                {
+                    REQUIRE(ids[idx++] == obj->id());
+                }
+                REQUIRE(ids.size() == orchestrator.size());
+            }
+        }
+
+        WHEN("Entities are moved to another SoA orchestrator")
+        {
+            orchestrator_t other;
+            for (uint64_t id = 0; id < initial_size; ++id)
+            {
+                orchestrator.move(other, orchestrator.get(id));
+            }
+
+            THEN("Fields are carried along")
+            {
+                for (uint64_t id = 0; id < initial_size; ++id)
+                {
+                    REQUIRE(other.field<1>(other.get(id)) == id);
+                    REQUIRE(other.field<0>(other.get(id)) == static_cast<float>(id));
+                }
+
+                for (uint64_t id = initial_size; id < initial_size * 3; ++id)
+                {
+                    REQUIRE(orchestrator.field<1>(orchestrator.get(id)) == id);
+                }
+            }
+        }
+    }
+}
+
+class tiered : public component<tiered>
+{
+public:
+    using component<tiered>::component;
+
+    inline void construct(uint8_t tier)
+    {
+        _tier = tier;
+    }
+
+    inline uint8_t tier() const
+    {
+        return _tier;
+    }
+
+    inline void tier(uint8_t tier)
+    {
+        _tier = tier;
+    }
+
+private:
+    uint8_t _tier;
+};
+
+template <typename O>
+inline void check_multi_partitions(O& orchestrator, uint32_t expected)
+{
+    uint32_t total = 0;
+    for (uint8_t partition = 0; partition < 4; ++partition)
+    {
+        uint32_t count = 0;
+        for (auto obj : orchestrator.range(partition))
+        {
+            REQUIRE(obj->tier() == partition);
+            REQUIRE(orchestrator.raw_storage().partition(obj) == partition);
+            REQUIRE(orchestrator.get(obj->id()) == obj);
+            ++count;
+        }
+
+        REQUIRE(count == orchestrator.size(partition));
+        total += count;
+    }
+
+    REQUIRE(total == expected);
+    REQUIRE(orchestrator.size() == expected);
+
+#if !defined(NDEBUG)
+    orchestrator.unlock_writes();
+#endif
+}
+
+SCENARIO("Multi-partitioned storages keep every partition contiguous", "[storage]")
+{
+    GIVEN("An orchestrator with four partitions and elements spread among them")
+    {
+        std::mt19937 gen(42);
+        std::uniform_int_distribution<> distrib(0, 3);
+
+        orchestrator<multi_partitioned<4>::growable_storage, tiered, 16> orchestrator;
+        for (uint64_t id = 0; id < initial_size * 2; ++id)
+        {
+            auto tier = static_cast<uint8_t>(distrib(gen));
+            orchestrator.push(tier, id, tier);
+        }
+
+        THEN("Each partition contains only its own elements")
+        {
+            check_multi_partitions(orchestrator, initial_size * 2);
+        }
+
+        WHEN("Elements change between arbitrary partitions")
+        {
+            for (uint64_t id = 0; id < initial_size * 2; id += 2)
+            {
+                auto obj = orchestrator.get(id);
+                auto tier = static_cast<uint8_t>((obj->tier() + 1 + id % 3) % 4);
+                obj = orchestrator.change_partition(tier, obj);
+                obj->tier(tier);
+
+                REQUIRE(obj->id() == id);
+                REQUIRE(orchestrator.get(id) == obj);
+            }
+
+            THEN("Partitions are still contiguous")
+            {
+                check_multi_partitions(orchestrator, initial_size * 2);
+            }
+        }
+
+        WHEN("Elements are popped from every partition")
+        {
+            std::vector<tiered*> objs;
+            for (uint64_t id = 0; id < initial_size * 2; id += 3)
+            {
+                objs.push_back(orchestrator.get(id));
+            }
+
+            orchestrator.pop_n(objs);
+
+            THEN("Partitions are still contiguous")
+            {
+                check_multi_partitions(orchestrator, initial_size * 2 - static_cast<uint32_t>(objs.size()));
+                for (uint64_t id = 0; id < initial_size * 2; id += 3)
+                {
+                    REQUIRE(orchestrator.get(id) == nullptr);
+                }
+            }
+        }
+
+        WHEN("A batch is pushed into a middle partition")
+        {
+            std::vector<uint64_t> ids(initial_size);
+            std::iota(ids.begin(), ids.end(), initial_size * 2);
+
+            std::vector<tiered*> out(ids.size());
+            orchestrator.push_n(out, 1, ids, static_cast<uint8_t>(1));
+
+            THEN("Partitions are still contiguous")
+            {
+                check_multi_partitions(orchestrator, initial_size * 3);
+            }
+        }
+
+        WHEN("Elements are moved to a partitioned storage and back")
+        {
+            ::orchestrator<partitioned_growable_storage, tiered, 16> other;
+            for (uint64_t id = 0; id < initial_size * 2; id += 4)
+            {
+                orchestrator.move(other, orchestrator.get(id), true);
+            }
+
+            for (auto obj : other.raw_storage().range())
+            {
+                obj->tier(3);
+            }
+
+            std::vector<tiered*> objs(other.raw_storage().range().begin(), other.raw_storage().range().end());
+            other.move_n(orchestrator, objs, static_cast<uint8_t>(3));
+
+            THEN("They are found in the given partition")
+            {
+                REQUIRE(other.size() == 0);
+                check_multi_partitions(orchestrator, initial_size * 2);
+            }
+        }
+    }
+}
@@ -4,7 +4,9 @@
 #include <entity/component.hpp>
 #include <entity/scheme.hpp>
 #include <storage/growable_storage.hpp>
+#include <storage/paged_growable_storage.hpp>
 #include <storage/partitioned_growable_storage.hpp>
+#include <storage/sparse_set_index.hpp>
 #include <storage/partitioned_static_storage.hpp>
 #include <storage/static_growable_storage.hpp>
 #include <storage/static_storage.hpp>
@@ -114,11 +116,12 @@ inline void generate_stability_tests(O& orchestrator)
     }
 }
 
-template <template <typename, uint32_t> typename O1, template <typename, uint32_t> typename O2>
+template <template <typename, uint32_t> typename O1, template <typename, uint32_t> typename O2, 
+    template <typename> typename I1 = map_index, template <typename> typename I2 = map_index>
 inline void generate_test_cases()
 {
-    orchestrator<O1, client, alloc_initial> orchestrator1;
-    orchestrator<O2, client, alloc_initial> orchestrator2;
+    orchestrator<O1, client, alloc_initial, I1> orchestrator1;
+    orchestrator<O2, client, alloc_initial, I2> orchestrator2;
 
     // Populate both orchestrators
     for (int i = 0; i < initial_size; ++i)
@@ -177,32 +180,182 @@ inline void generate_test_cases()
 SCENARIO("Tests orchestrator moves", "[orchestrator]")
 {
     generate_test_cases<growable_storage, growable_storage>();
+    generate_test_cases<growable_storage, paged_growable_storage>();
     generate_test_cases<growable_storage, partitioned_growable_storage>();
     generate_test_cases<growable_storage, partitioned_static_storage>();
     generate_test_cases<growable_storage, static_growable_storage>();
     generate_test_cases<growable_storage, static_storage>();
 
+    generate_test_cases<paged_growable_storage, growable_storage>();
+    generate_test_cases<paged_growable_storage, paged_growable_storage>();
+    generate_test_cases<paged_growable_storage, partitioned_growable_storage>();
+    generate_test_cases<paged_growable_storage, partitioned_static_storage>();
+    generate_test_cases<paged_growable_storage, static_growable_storage>();
+    generate_test_cases<paged_growable_storage, static_storage>();
+
     generate_test_cases<partitioned_growable_storage, growable_storage>();
+    generate_test_cases<partitioned_growable_storage, paged_growable_storage>();
     generate_test_cases<partitioned_growable_storage, partitioned_growable_storage>();
     generate_test_cases<partitioned_growable_storage, partitioned_static_storage>();
     generate_test_cases<partitioned_growable_storage, static_growable_storage>();
     generate_test_cases<partitioned_growable_storage, static_storage>();
 
     generate_test_cases<partitioned_static_storage, growable_storage>();
+    generate_test_cases<partitioned_static_storage, paged_growable_storage>();
     generate_test_cases<partitioned_static_storage, partitioned_growable_storage>();
     generate_test_cases<partitioned_static_storage, partitioned_static_storage>();
     generate_test_cases<partitioned_static_storage, static_growable_storage>();
     generate_test_cases<partitioned_static_storage, static_storage>();
 
     generate_test_cases<static_growable_storage, growable_storage>();
+    generate_test_cases<static_growable_storage, paged_growable_storage>();
     generate_test_cases<static_growable_storage, partitioned_growable_storage>();
     generate_test_cases<static_growable_storage, partitioned_static_storage>();
     generate_test_cases<static_growable_storage, static_growable_storage>();
     generate_test_cases<static_growable_storage, static_storage>();
 
     generate_test_cases<static_storage, growable_storage>();
+    generate_test_cases<static_storage, paged_growable_storage>();
     generate_test_cases<static_storage, partitioned_growable_storage>();
     generate_test_cases<static_storage, partitioned_static_storage>();
     generate_test_cases<static_storage, static_growable_storage>();
     generate_test_cases<static_storage, static_storage>();
 }
+
+template <template <typename, uint32_t> typename O1, template <typename, uint32_t> typename O2>
+inline void generate_bulk_test_cases()
+{
+    orchestrator<O1, client, alloc_initial> orchestrator1;
+    orchestrator<O2, client, alloc_initial> orchestrator2;
+
+    for (int i = 0; i < initial_size; ++i)
+    {
+        push_random_partition_if_available(orchestrator1, i);
+        push_random_partition_if_available(orchestrator2, initial_size + i);
+    }
+
+    GIVEN("Orchestrators " + std::string(typeid(orchestrator1).name()) + " and " + std::string(typeid(orchestrator2).name()))
+    {
+        WHEN("A batch of elements is moved at once")
+        {
+            std::vector<client*> objs;
+            for (uint64_t id = 0; id < initial_size; id += 3)
+            {
+                objs.push_back(orchestrator1.get(id));
+            }
+
+            orchestrator1.move_n(orchestrator2, objs, true);
+
+            THEN("Moved elements are found, in order, only in the destination")
+            {
+                REQUIRE(orchestrator1.size() + orchestrator2.size() == initial_size * 2);
+                for (std::size_t idx = 0; idx < objs.size(); ++idx)
+                {
+                    REQUIRE(objs[idx]->id() == idx * 3);
+                    REQUIRE(orchestrator2.get(idx * 3) == objs[idx]);
+                    REQUIRE(orchestrator1.get(idx * 3) == nullptr);
+                }
+            }
+
+            THEN("Remaining elements are still found in the source")
+            {
+                for (uint64_t id = 0; id < initial_size; ++id)
+                {
+                    if (id % 3 != 0)
+                    {
+                        REQUIRE(orchestrator1.get(id)->id() == id);
+                    }
+                }
+
+                int count = 0;
+                for (auto x : orchestrator1.range())
+                {
+                    ++count;
+                }
+                REQUIRE(count == orchestrator1.size());
+
+#if !defined(NDEBUG)
+                orchestrator1.unlock_writes();
+#endif
+            }
+        }
+    }
+}
+
+SCENARIO("Tests orchestrator bulk moves", "[orchestrator]")
+{
+    generate_bulk_test_cases<growable_storage, paged_growable_storage>();
+    generate_bulk_test_cases<paged_growable_storage, static_growable_storage>();
+    generate_bulk_test_cases<partitioned_growable_storage, partitioned_static_storage>();
+    generate_bulk_test_cases<partitioned_static_storage, growable_storage>();
+    generate_bulk_test_cases<static_growable_storage, partitioned_growable_storage>();
+    generate_bulk_test_cases<static_storage, static_growable_storage>();
+}
+
+SCENARIO("Bulk moves resolve pointers once every element has landed", "[orchestrator]")
+{
+    GIVEN("A source holding more elements than the destination initially fits")
+    {
+        orchestrator<partitioned_growable_storage, client, alloc_initial> source;
+        for (int i = 0; i < initial_size; ++i)
+        {
+            source.push(i % 2 == 0, i, i % 2 == 0);
+        }
+
+        std::vector<client*> objs;
+        for (uint64_t id = 0; id < initial_size; ++id)
+        {
+            objs.push_back(source.get(id));
+        }
+
+        WHEN("They are moved into an empty growable destination")
+        {
+            orchestrator<growable_storage, client, 16> destination;
+            source.move_n(destination, objs);
+
+            THEN("Every pointer refers to its element in the destination")
+            {
+                REQUIRE(destination.size() == initial_size);
+                for (uint64_t id = 0; id < initial_size; ++id)
+                {
+                    REQUIRE(objs[id]->id() == id);
+                    REQUIRE(destination.get(id) == objs[id]);
+                }
+            }
+        }
+
+        WHEN("They are moved into a partitioned destination, mixing both partitions")
+        {
+            orchestrator<partitioned_growable_storage, client, 16> destination;
+            source.move_n(destination, objs);
+
+            THEN("Every pointer refers to its element, within its partition")
+            {
+                REQUIRE(destination.size() == initial_size);
+                for (uint64_t id = 0; id < initial_size; ++id)
+                {
+                    REQUIRE(objs[id]->id() == id);
+                    REQUIRE(destination.get(id) == objs[id]);
+                    REQUIRE(objs[id]->partition() == (id % 2 == 0));
+                }
+
+                for (auto obj : destination.range_until_partition())
+                {
+                    REQUIRE(obj->partition());
+                }
+
+#if !defined(NDEBUG)
+                destination.unlock_writes();
+#endif
+            }
+        }
+    }
+}
+
+SCENARIO("Tests orchestrator moves across index types", "[orchestrator]")
+{
+    generate_test_cases<growable_storage, growable_storage, sparse_set_index, sparse_set_index>();
+    generate_test_cases<growable_storage, partitioned_static_storage, map_index, sparse_set_index>();
+    generate_test_cases<partitioned_growable_storage, static_storage, sparse_set_index, map_index>();
+    generate_test_cases<static_growable_storage, partitioned_growable_storage, sparse_set_index, sparse_set_index>();
+}
@@ -1,8 +1,10 @@
 #include <catch2/catch_all.hpp>
+#include <numeric>
 
 #include <entity/component.hpp>
 #include <entity/scheme.hpp>
 #include <storage/growable_storage.hpp>
+#include <storage/paged_growable_storage.hpp>
 #include <storage/partitioned_growable_storage.hpp>
 #include <storage/partitioned_static_storage.hpp>
 #include <storage/static_growable_storage.hpp>
@@ -253,6 +255,40 @@ void test_instantiation_with_storage()
                 REQUIRE(tao::get<client*>(entity)->id() == 1);
                 REQUIRE(tao::get<npc*>(entity)->id() == 1);
             }
+
+            THEN("components can find their siblings")
+            {
+                auto client_ptr = tao::get<client*>(entity);
+                auto npc_ptr = tao::get<npc*>(entity);
+
+                REQUIRE(client_ptr->components()->size() == 2);
+                REQUIRE(client_ptr->template get<npc>() == npc_ptr);
+                REQUIRE(npc_ptr->template get<client>() == client_ptr);
+                REQUIRE(npc_ptr->template get<non_registered_component>() == nullptr);
+            }
+
+            THEN("siblings can be found by their scheme index")
+            {
+                constexpr auto npc_index = decltype(scheme)::template component_index<npc>();
+                REQUIRE(npc_index == 1);
+                REQUIRE(tao::get<client*>(entity)->template get<npc>(npc_index) == tao::get<npc*>(entity));
+            }
+
+            THEN("components beyond the scheme ones can be pushed")
+            {
+                ::orchestrator<growable_storage, non_registered_component, 128> extra;
+                auto extra_ptr = extra.push(1);
+
+                auto client_ptr = tao::get<client*>(entity);
+                client_ptr->push_component(extra_ptr);
+
+                REQUIRE(client_ptr->components()->size() == 3);
+                REQUIRE(client_ptr->template get<non_registered_component>() == extra_ptr);
+                REQUIRE(client_ptr->template get<npc>() == tao::get<npc*>(entity));
+                REQUIRE(tao::get<npc*>(entity)->template get<client>() == client_ptr);
+
+                extra.pop(extra_ptr);
+            }
         }
     }
 }
@@ -320,6 +356,17 @@ void test_destruction_with_storage()
                 REQUIRE(tao::get<client*>(other) != other_tickets.template get<client>());
                 REQUIRE(other_tickets.template get<client>()->id() == 2);
             }
+
+            THEN("the second entity's siblings still find it after it moved")
+            {
+                constexpr auto npc_index = decltype(scheme)::template component_index<npc>();
+                auto client_ptr = other_tickets.template get<client>();
+                auto npc_ptr = other_tickets.template get<npc>();
+
+                REQUIRE(client_ptr->template get<npc>() == npc_ptr);
+                REQUIRE(client_ptr->template get<npc>(npc_index) == npc_ptr);
+                REQUIRE(npc_ptr->template get<client>() == client_ptr);
+            }
         }
 
         WHEN("two entities are created and the second is freed")
@@ -350,12 +397,316 @@ void test_destruction_with_storage()
                 REQUIRE(ticket->get()->id() == 1);
             }
         }
+
+        WHEN("two entities are created, their handles are taken and the first is freed")
+        {
+            auto entity = scheme.create(1,
+                get_args<client, S<client, 128>>(scheme),
+                get_args<npc, S<npc, 128>>(scheme));
+
+            auto other = scheme.create(2,
+                get_args<client, S<client, 128>>(scheme),
+                get_args<npc, S<npc, 128>>(scheme));
+
+            auto handle = tao::get<client*>(entity)->handle();
+            auto other_handle = tao::get<client*>(other)->handle();
+
+            scheme.destroy(entity);
+
+            THEN("the freed entity's handle is no longer valid")
+            {
+                REQUIRE(!handle.valid());
+                REQUIRE(handle.get() == nullptr);
+            }
+
+            THEN("the second entity's handle follows it")
+            {
+                REQUIRE(other_handle.valid());
+                REQUIRE(other_handle.get()->id() == 2);
+                REQUIRE(handle_of_t<client>::from_value(other_handle.value()) == other_handle);
+            }
+
+            THEN("reusing the freed slot does not revive the old handle")
+            {
+                auto reused = scheme.create(3,
+                    get_args<client, S<client, 128>>(scheme),
+                    get_args<npc, S<npc, 128>>(scheme));
+
+                REQUIRE(!handle.valid());
+                REQUIRE(handle.get() == nullptr);
+                REQUIRE(tao::get<client*>(reused)->handle().valid());
+            }
+
+            THEN("an empty handle is not valid and resolves to nothing")
+            {
+                handle_of_t<client> empty;
+                REQUIRE(!empty.valid());
+                REQUIRE(empty.get() == nullptr);
+            }
+        }
+    }
+}
+
+template <template <typename, uint32_t> typename S>
+void test_ticket_allocation_with_storage()
+{
+    GIVEN("a " + std::string(typeid(S<client, 128>).name()) + " store and a scheme with two components")
+    {
+        scheme_store<
+            S<client, 128>,
+            S<npc, 128>
+        > store;
+
+        auto scheme = scheme_maker<client, npc>()(store);
+
+        WHEN("entities are repeatedly created and destroyed")
+        {
+            auto churn = [&scheme]() {
+                for (int i = 0; i < 100; ++i)
+                {
+                    scheme.create(i,
+                        get_args<client, S<client, 128>>(scheme),
+                        get_args<npc, S<npc, 128>>(scheme));
+                }
+
+                scheme.clear();
+            };
+
+            churn();
+            auto warm = slot_table<component<client>>::instance().stats();
+
+            for (int i = 0; i < 10; ++i)
+            {
+                churn();
+            }
+
+            THEN("tickets are recycled without allocating more pages")
+            {
+                auto stats = slot_table<component<client>>::instance().stats();
+                REQUIRE(stats.pages == warm.pages);
+                REQUIRE(stats.slots == warm.slots);
+            }
+        }
+    }
+}
+
+template <template <typename, uint32_t> typename S>
+void test_batch_with_storage()
+{
+    GIVEN("a " + std::string(typeid(S<client, 128>).name()) + " store and a scheme with two components")
+    {
+        scheme_store<
+            S<client, 128>,
+            S<npc, 128>
+        > store;
+
+        auto scheme = scheme_maker<client, npc>()(store);
+
+        WHEN("a batch of entities is created")
+        {
+            std::vector<uint64_t> ids(100);
+            std::iota(ids.begin(), ids.end(), 0);
+
+            auto entities = scheme.create_n(ids,
+                get_args<client, S<client, 128>>(scheme, 1),
+                get_args<npc, S<npc, 128>>(scheme));
+
+            THEN("all of them are fully constructed")
+            {
+                REQUIRE(scheme.size() == ids.size());
+                for (std::size_t idx = 0; idx < ids.size(); ++idx)
+                {
+                    auto client_ptr = tao::get<client*>(entities[idx]);
+                    REQUIRE(client_ptr->id() == ids[idx]);
+                    REQUIRE(client_ptr->constructor_called);
+                    REQUIRE(client_ptr->template get<npc>() == tao::get<npc*>(entities[idx]));
+                    REQUIRE(scheme.template get<npc>(ids[idx]) == tao::get<npc*>(entities[idx]));
+                }
+            }
+
+            AND_WHEN("every other entity is destroyed in a batch")
+            {
+                std::vector<typename decltype(scheme)::entity_tuple_t> destroyed;
+                for (std::size_t idx = 0; idx < entities.size(); idx += 2)
+                {
+                    destroyed.push_back(entities[idx]);
+                }
+
+                auto tickets = destroyed.front().tickets();
+                scheme.destroy_n(destroyed);
+
+                THEN("only the rest remain")
+                {
+                    REQUIRE(scheme.size() == ids.size() / 2);
+                    REQUIRE(!tickets.template valid<client>());
+                    REQUIRE(!tickets.template valid<npc>());
+
+                    for (uint64_t id = 1; id < ids.size(); id += 2)
+                    {
+                        auto entity = scheme.search(id);
+                        REQUIRE(entity.template get<client>()->id() == id);
+                        REQUIRE(entity.template get<npc>()->id() == id);
+                    }
+                }
+            }
+        }
+    }
+}
+
+template <template <typename, uint32_t> typename S>
+void test_bulk_move_with_storage()
+{
+    GIVEN("a " + std::string(typeid(S<client, 128>).name()) + " store and two schemes with the same components")
+    {
+        scheme_store<
+            S<client, 128>,
+            S<npc, 128>
+        > store;
+
+        scheme_store<
+            S<client, 128>,
+            S<npc, 128>
+        > other_store;
+
+        auto scheme = scheme_maker<client, npc>()(store);
+        auto other = scheme_maker<client, npc>()(other_store);
+
+        for (int i = 0; i < 100; ++i)
+        {
+            scheme.create(i,
+                get_args<client, S<client, 128>>(scheme),
+                get_args<npc, S<npc, 128>>(scheme));
+        }
+
+        WHEN("entities matching a predicate are moved at once")
+        {
+            auto moved = scheme.move_if(other, [](client* client, npc* npc) { return client->id() % 4 == 0; });
+
+            THEN("they are all found in the destination scheme")
+            {
+                REQUIRE(moved.size() == 25);
+                REQUIRE(scheme.size() == 75);
+                REQUIRE(other.size() == 25);
+
+                for (auto& entity : moved)
+                {
+                    REQUIRE(entity.template get<client>()->id() % 4 == 0);
+                    REQUIRE(entity.template get<client>() == other.template get<client>(entity.id()));
+                    REQUIRE(entity.template get<npc>() == other.template get<npc>(entity.id()));
+                    REQUIRE(entity.template get<client>()->template get<npc>() == entity.template get<npc>());
+                }
+            }
+
+            THEN("the rest remain in the source scheme")
+            {
+                for (uint64_t id = 1; id < 100; ++id)
+                {
+                    if (id % 4 != 0)
+                    {
+                        auto entity = scheme.search(id);
+                        REQUIRE(entity.template get<client>()->id() == id);
+                        REQUIRE(entity.template get<npc>()->id() == id);
+                    }
+                }
+            }
+
+            AND_WHEN("they are moved back as a list")
+            {
+                other.move_n(scheme, moved);
+
+                THEN("every entity is back in the source scheme")
+                {
+                    REQUIRE(scheme.size() == 100);
+                    REQUIRE(other.size() == 0);
+                    for (auto& entity : moved)
+                    {
+                        REQUIRE(entity.template get<client>() == scheme.template get<client>(entity.id()));
+                        REQUIRE(entity.template get<npc>() == scheme.template get<npc>(entity.id()));
+                    }
+                }
+            }
+        }
+
+    }
+}
+
+template <template <typename, uint32_t> typename S>
+void test_batch_partition_with_storage()
+{
+    GIVEN("a " + std::string(typeid(S<client, 128>).name()) + " store and a scheme with entities in both partitions")
+    {
+        scheme_store<
+            S<client, 128>,
+            S<npc, 128>
+        > store;
+
+        auto scheme = scheme_maker<client, npc>()(store);
+
+        for (int i = 0; i < 100; ++i)
+        {
+            scheme.create(i, scheme.template args<client>(i % 2 == 0), scheme.template args<npc>(i % 2 == 0));
+        }
+
+        WHEN("the scheme is partitioned by a predicate")
+        {
+            auto changed = scheme.partition([](client* client, npc* npc) { return client->id() % 3 == 0; });
+
+            THEN("only entities on the wrong side have changed")
+            {
+                // Even and multiple of 3 stay, odd multiples of 3 and even non-multiples change
+                REQUIRE(changed.size() == 17 + 33);
+                REQUIRE(scheme.size_until_partition() == 34);
+                REQUIRE(scheme.size_from_partition() == 66);
+            }
+
+            THEN("every component is in the partition given by the predicate")
+            {
+                for (auto& entity : changed)
+                {
+                    REQUIRE(entity.template get<client>() == scheme.template get<client>(entity.id()));
+                    REQUIRE(entity.template get<npc>() == scheme.template get<npc>(entity.id()));
+                }
+
+                for (uint64_t id = 0; id < 100; ++id)
+                {
+                    auto entity = scheme.search(id);
+                    REQUIRE(entity.template get<client>()->id() == id);
+                    REQUIRE(entity.template get<npc>()->id() == id);
+                    REQUIRE(scheme.template get<client>().raw_storage().partition(entity.template get<client>()) == (id % 3 == 0));
+                    REQUIRE(scheme.template get<npc>().raw_storage().partition(entity.template get<npc>()) == (id % 3 == 0));
+                }
+            }
+        }
+
+        WHEN("a list of entities is moved to the false partition")
+        {
+            std::vector<typename decltype(scheme)::entity_tuple_t> entities;
+            for (uint64_t id = 0; id < 50; ++id)
+            {
+                entities.push_back(scheme.search(id));
+            }
+
+            scheme.change_partition_n(false, entities);
+
+            THEN("all of them are found in the false partition")
+            {
+                REQUIRE(scheme.size_until_partition() == 25);
+                for (uint64_t id = 0; id < 50; ++id)
+                {
+                    REQUIRE(entities[id].template get<client>() == scheme.template get<client>(id));
+                    REQUIRE(entities[id].template get<npc>() == scheme.template get<npc>(id));
+                    REQUIRE(!scheme.template get<client>().raw_storage().partition(entities[id].template get<client>()));
+                    REQUIRE(!scheme.template get<npc>().raw_storage().partition(entities[id].template get<npc>()));
+                }
+            }
+        }
     }
 }
 
 SCENARIO("schemes can be created", "[scheme]") 
 {
     test_scheme_creation_with_storage<growable_storage>();
+    test_scheme_creation_with_storage<paged_growable_storage>();
     test_scheme_creation_with_storage<partitioned_growable_storage>();
     test_scheme_creation_with_storage<partitioned_static_storage>();
     test_scheme_creation_with_storage<static_growable_storage>();
@@ -365,6 +716,7 @@ SCENARIO("schemes can be created", "[scheme]")
 SCENARIO("schemes can be used to instantiate entities")
 {
     test_instantiation_with_storage<growable_storage>();
+    test_instantiation_with_storage<paged_growable_storage>();
     test_instantiation_with_storage<partitioned_growable_storage>();
     test_instantiation_with_storage<partitioned_static_storage>();
     test_instantiation_with_storage<static_growable_storage>();
@@ -374,9 +726,91 @@ SCENARIO("schemes can be used to instantiate entities")
 SCENARIO("schemes can be used to instantiate entities and free them")
 {
     test_destruction_with_storage<growable_storage>();
+    test_destruction_with_storage<paged_growable_storage>();
     test_destruction_with_storage<partitioned_growable_storage>();
     test_destruction_with_storage<partitioned_static_storage>();
     test_destruction_with_storage<static_growable_storage>();
     test_destruction_with_storage<static_storage>();
 }
 
+SCENARIO("schemes can create and destroy entities in batches")
+{
+    test_batch_with_storage<growable_storage>();
+    test_batch_with_storage<paged_growable_storage>();
+    test_batch_with_storage<partitioned_growable_storage>();
+    test_batch_with_storage<partitioned_static_storage>();
+    test_batch_with_storage<static_growable_storage>();
+    test_batch_with_storage<static_storage>();
+}
+
+SCENARIO("schemes can move entities in bulk")
+{
+    test_bulk_move_with_storage<growable_storage>();
+    test_bulk_move_with_storage<paged_growable_storage>();
+    test_bulk_move_with_storage<partitioned_growable_storage>();
+    test_bulk_move_with_storage<partitioned_static_storage>();
+    test_bulk_move_with_storage<static_growable_storage>();
+    test_bulk_move_with_storage<static_storage>();
+}
+
+SCENARIO("schemes can change partitions in batches")
+{
+    test_batch_partition_with_storage<partitioned_growable_storage>();
+    test_batch_partition_with_storage<partitioned_static_storage>();
+}
+
+SCENARIO("schemes recycle tickets once warm")
+{
+    test_ticket_allocation_with_storage<growable_storage>();
+    test_ticket_allocation_with_storage<paged_growable_storage>();
+    test_ticket_allocation_with_storage<partitioned_growable_storage>();
+    test_ticket_allocation_with_storage<partitioned_static_storage>();
+    test_ticket_allocation_with_storage<static_growable_storage>();
+    test_ticket_allocation_with_storage<static_storage>();
+}
+
+#if defined(UMI_SLIM_COMPONENTS)
+class slim_position : public component<slim_position>
+{
+public:
+    using component<slim_position>::component;
+
+    float x;
+};
+
+SCENARIO("slim components have a compact header")
+{
+    GIVEN("a component with a single float")
+    {
+        THEN("the header is a ticket, a pointer and a 32 bits id")
+        {
+            REQUIRE(sizeof(component<slim_position>) == 24);
+        }
+
+        THEN("the payload reuses the header tail padding")
+        {
+            REQUIRE(sizeof(slim_position) == 24);
+        }
+    }
+
+    GIVEN("a scheme with two slim components")
+    {
+        scheme_store<growable_storage<client, 128>, growable_storage<slim_position, 128>> store;
+        auto scheme = scheme_maker<client, slim_position>()(store);
+
+        WHEN("an entity is created")
+        {
+            auto entity = scheme.create(7, scheme.args<client>(), scheme.args<slim_position>());
+
+            THEN("components can still find each other")
+            {
+                REQUIRE(entity.get<client>()->id() == 7);
+                REQUIRE(entity.get<client>()->get<slim_position>() == entity.get<slim_position>());
+                REQUIRE(entity.get<slim_position>()->get<client>() == entity.get<client>());
+            }
+
+            scheme.destroy(entity);
+        }
+    }
+}
+#endif
@@ -1,12 +1,18 @@
 #include <catch2/catch_all.hpp>
 
+#include <entity/command_buffer.hpp>
 #include <entity/component.hpp>
+#include <entity/owning_group.hpp>
 #include <entity/scheme.hpp>
 #include <storage/growable_storage.hpp>
+#include <storage/multi_partitioned_storage.hpp>
+#include <storage/paged_growable_storage.hpp>
 #include <storage/partitioned_growable_storage.hpp>
 #include <storage/partitioned_static_storage.hpp>
 #include <storage/static_growable_storage.hpp>
 #include <storage/static_storage.hpp>
+#include <view/group_view.hpp>
+#include <view/parallel_for.hpp>
 #include <view/scheme_view.hpp>
 
 
@@ -127,6 +133,60 @@ void test_iteration_with_single_storage()
                 pool.join();
             }
         }
+
+        WHEN("many entities are created in the scheme")
+        {
+            static constexpr int num_entities = 120;
+            for (int i = 0; i < num_entities; ++i)
+            {
+                scheme.create(i, get_args<client, S<client, 128>>(scheme), get_args<npc, S<npc, 128>>(scheme));
+            }
+
+            np::fiber_pool<> pool;
+
+            THEN("they can be iterated in parallel slices with a view")
+            {
+                pool.push([&pool, &scheme] {
+                    np::counter counter;
+                    std::atomic<uint16_t> idx = 0;
+                    std::atomic<uint64_t> ids = 0;
+                    scheme_view::parallel_chunked(counter, &pool, scheme, [&idx, &ids](auto client, auto npc)
+                        {
+                            REQUIRE(client->id() == npc->id());
+                            ids += client->id();
+                            ++idx;
+                        }, 16);
+
+                    counter.wait();
+                    REQUIRE(idx == num_entities);
+                    REQUIRE(ids == num_entities * (num_entities - 1) / 2);
+                    pool.end();
+                });
+
+                pool.start();
+                pool.join();
+            }
+
+            THEN("they can be iterated in auto-tuned parallel slices by a component")
+            {
+                pool.push([&pool, &scheme] {
+                    np::counter counter;
+                    std::atomic<uint16_t> idx = 0;
+                    scheme_view::parallel_by_chunked<client>(counter, &pool, scheme, [&idx](auto client, auto npc)
+                        {
+                            REQUIRE(client->id() == npc->id());
+                            ++idx;
+                        });
+
+                    counter.wait();
+                    REQUIRE(idx == num_entities);
+                    pool.end();
+                });
+
+                pool.start();
+                pool.join();
+            }
+        }
     }
 }
 //
@@ -150,9 +210,675 @@ void test_iteration_with_single_storage()
 SCENARIO("schemes can be iterated with scheme views")
 {
     test_iteration_with_single_storage<growable_storage>();
+    test_iteration_with_single_storage<paged_growable_storage>();
     test_iteration_with_single_storage<partitioned_growable_storage>();
     test_iteration_with_single_storage<partitioned_static_storage>();
     test_iteration_with_single_storage<static_growable_storage>();
     test_iteration_with_single_storage<static_storage>();
 }
 
+
+SCENARIO("mixed layout schemes can be iterated in prefetched batches")
+{
+    GIVEN("a scheme mixing continuous and partitioned storages")
+    {
+        scheme_store<
+            growable_storage<client, 128>,
+            partitioned_growable_storage<npc, 128>
+        > store;
+
+        auto scheme = scheme_maker<client, npc>()(store);
+
+        static constexpr int num_entities = 100;
+        for (int i = 0; i < num_entities; ++i)
+        {
+            scheme.create(i, scheme.template args<client>(), scheme.template args<npc>(i % 3 == 0));
+        }
+
+        np::fiber_pool<> pool;
+
+        THEN("they can be iterated continuously by a component")
+        {
+            pool.push([&pool, &scheme] {
+                np::counter counter;
+                auto idx = 0;
+                scheme_view::continuous_by_batched<client>(counter, &pool, scheme, [&idx](auto client, auto npc)
+                    {
+                        REQUIRE(client->id() == idx);
+                        REQUIRE(npc->id() == idx);
+                        ++idx;
+                    });
+
+                counter.wait();
+                REQUIRE(idx == num_entities);
+                pool.end();
+            });
+
+            pool.start();
+            pool.join();
+        }
+
+        THEN("they can be iterated in parallel by a component")
+        {
+            pool.push([&pool, &scheme] {
+                np::counter counter;
+                std::atomic<uint16_t> idx = 0;
+                scheme_view::parallel_by_batched<npc>(counter, &pool, scheme, [&idx](auto client, auto npc)
+                    {
+                        REQUIRE(client->id() == npc->id());
+                        ++idx;
+                    }, 40);
+
+                counter.wait();
+                REQUIRE(idx == num_entities);
+                pool.end();
+            });
+
+            pool.start();
+            pool.join();
+        }
+    }
+}
+
+SCENARIO("schemes spread over many spans can be iterated in slices")
+{
+    GIVEN("a scheme whose storages are made of pages and overflow buffers of different sizes")
+    {
+        scheme_store<
+            paged_growable_storage<client, 16>,
+            static_growable_storage<npc, 24>
+        > store;
+
+        auto scheme = scheme_maker<client, npc>()(store);
+
+        static constexpr int num_entities = 100;
+        for (int i = 0; i < num_entities; ++i)
+        {
+            scheme.create(i, scheme.template args<client>(), scheme.template args<npc>());
+        }
+
+        np::fiber_pool<> pool;
+
+        THEN("slices straddling spans still visit every entity once")
+        {
+            pool.push([&pool, &scheme] {
+                np::counter counter;
+                std::atomic<uint16_t> idx = 0;
+                std::atomic<uint64_t> ids = 0;
+                scheme_view::parallel_chunked(counter, &pool, scheme, [&idx, &ids](auto client, auto npc)
+                    {
+                        REQUIRE(client->id() == npc->id());
+                        ids += client->id();
+                        ++idx;
+                    }, 7);
+
+                counter.wait();
+                REQUIRE(idx == num_entities);
+                REQUIRE(ids == num_entities * (num_entities - 1) / 2);
+                pool.end();
+            });
+
+            pool.start();
+            pool.join();
+        }
+
+        THEN("batched slices by a component still visit every entity once")
+        {
+            pool.push([&pool, &scheme] {
+                np::counter counter;
+                std::atomic<uint16_t> idx = 0;
+                std::atomic<uint64_t> ids = 0;
+                scheme_view::parallel_by_batched<npc>(counter, &pool, scheme, [&idx, &ids](auto client, auto npc)
+                    {
+                        REQUIRE(client->id() == npc->id());
+                        ids += client->id();
+                        ++idx;
+                    }, 10);
+
+                counter.wait();
+                REQUIRE(idx == num_entities);
+                REQUIRE(ids == num_entities * (num_entities - 1) / 2);
+                pool.end();
+            });
+
+            pool.start();
+            pool.join();
+        }
+    }
+}
+
+template <template <typename, uint32_t> typename S>
+void test_parallel_for_with_storage()
+{
+    GIVEN("a " + std::string(typeid(S<client, 128>).name()) + " orchestrator with skewed entities")
+    {
+        static constexpr int num_entities = 2000;
+        orchestrator<S, client, 128> orchestrator;
+        for (int i = 0; i < num_entities; ++i)
+        {
+            if constexpr (is_partitioned_storage(S<client, 128>::tag))
+            {
+                orchestrator.push(i % 2 == 0, i);
+            }
+            else
+            {
+                orchestrator.push(i);
+            }
+        }
+
+        np::fiber_pool<> pool;
+
+        THEN("parallel_for visits every entity exactly once")
+        {
+            pool.push([&pool, &orchestrator] {
+                np::counter counter;
+                std::vector<std::atomic<uint8_t>> visits(num_entities);
+                parallel_for(counter, &pool, orchestrator, [&visits](client* client)
+                    {
+                        // Only a few entities are expensive
+                        if (client->id() < 16)
+                        {
+                            std::this_thread::sleep_for(std::chrono::microseconds(200));
+                        }
+
+                        ++visits[client->id()];
+                    }, 8);
+
+                counter.wait();
+                REQUIRE(std::all_of(visits.begin(), visits.end(), [](auto& v) { return v == 1; }));
+                pool.end();
+            });
+
+            pool.start();
+            pool.join();
+        }
+    }
+}
+
+SCENARIO("orchestrators can be iterated with an adaptive parallel_for")
+{
+    test_parallel_for_with_storage<growable_storage>();
+    test_parallel_for_with_storage<paged_growable_storage>();
+    test_parallel_for_with_storage<partitioned_growable_storage>();
+    test_parallel_for_with_storage<static_growable_storage>();
+}
+
+template <template <typename, uint32_t> typename S, uint32_t N>
+void test_owning_group_with_storage()
+{
+    GIVEN("a " + std::string(typeid(S<client, N>).name()) + " store shared by two schemes and a group owning one of them")
+    {
+        scheme_store<
+            S<client, N>,
+            S<npc, N>
+        > store;
+
+        auto both = scheme_maker<client, npc>()(store);
+        auto only = scheme_maker<client>()(store);
+
+        // Client storages are shared by both schemes, thus their indices do not match the npc ones
+        static constexpr int num_entities = 90;
+        auto create = [&both, &only](int i) {
+            if (i % 3 == 0)
+            {
+                only.create(i, only.template args<client>());
+            }
+            else
+            {
+                both.create(i, both.template args<client>(), both.template args<npc>());
+            }
+        };
+
+        for (int i = 0; i < num_entities / 2; ++i)
+        {
+            create(i);
+        }
+
+        owning_group group(both);
+
+        for (int i = num_entities / 2; i < num_entities; ++i)
+        {
+            create(i);
+        }
+
+        for (int i = 0; i < num_entities; i += 5)
+        {
+            if (i % 3 == 0)
+            {
+                only.destroy(only.template get<client>(i));
+            }
+            else
+            {
+                both.destroy(both.search(i));
+            }
+        }
+
+        int expected = 0;
+        for (int i = 0; i < num_entities; ++i)
+        {
+            expected += (i % 3 != 0 && i % 5 != 0);
+        }
+
+        np::fiber_pool<> pool;
+
+        THEN("the group zips its members without searching")
+        {
+            pool.push([&pool, &group, expected] {
+                np::counter counter;
+                int count = 0;
+                group_view::continuous(counter, &pool, group, [&count](auto client, auto npc)
+                    {
+                        REQUIRE(client->id() == npc->id());
+                        REQUIRE(client->id() % 3 != 0);
+                        REQUIRE(client->id() % 5 != 0);
+                        ++count;
+                    });
+
+                counter.wait();
+                REQUIRE(count == expected);
+                REQUIRE(group.size() == expected);
+                pool.end();
+            });
+
+            pool.start();
+            pool.join();
+        }
+
+        THEN("the group can be iterated in parallel slices")
+        {
+            pool.push([&pool, &group, expected] {
+                np::counter counter;
+                std::atomic<int> count = 0;
+                group_view::parallel_chunked(counter, &pool, group, [&count](auto client, auto npc)
+                    {
+                        REQUIRE(client->id() == npc->id());
+                        ++count;
+                    }, 8);
+
+                counter.wait();
+                REQUIRE(count == expected);
+                pool.end();
+            });
+
+            pool.start();
+            pool.join();
+        }
+
+        WHEN("entities are moved out of the grouped scheme")
+        {
+            scheme_store<
+                S<client, N>,
+                S<npc, N>
+            > other_store;
+            auto other = scheme_maker<client, npc>()(other_store);
+
+            for (int i = 1; i < num_entities; i += 7)
+            {
+                if (i % 3 != 0 && i % 5 != 0)
+                {
+                    both.move(other, both.search(i));
+                    --expected;
+                }
+            }
+
+            group.refresh();
+
+            THEN("the remaining members are still aligned")
+            {
+                REQUIRE(group.size() == expected);
+                for (auto [client, npc] : group.range())
+                {
+                    REQUIRE(client->id() == npc->id());
+                }
+
+#if !defined(NDEBUG)
+                group.template get<client>().unlock_writes();
+                group.template get<npc>().unlock_writes();
+#endif
+            }
+        }
+    }
+}
+
+SCENARIO("owning groups keep their members in lockstep order")
+{
+    test_owning_group_with_storage<growable_storage, 128>();
+    test_owning_group_with_storage<paged_growable_storage, 16>();
+    test_owning_group_with_storage<static_growable_storage, 16>();
+    test_owning_group_with_storage<static_storage, 128>();
+}
+
+SCENARIO("multi-partitioned schemes can be iterated one partition at a time")
+{
+    GIVEN("a scheme whose entities are spread among three partitions")
+    {
+        scheme_store<
+            multi_partitioned<3>::growable_storage<client, 128>,
+            multi_partitioned<3>::growable_storage<npc, 128>
+        > store;
+
+        auto scheme = scheme_maker<client, npc>()(store);
+
+        static constexpr int num_entities = 90;
+        for (int i = 0; i < num_entities; ++i)
+        {
+            auto partition = static_cast<uint8_t>(i % 3);
+            scheme.create(i, scheme.template args<client>(partition), scheme.template args<npc>(partition));
+        }
+
+        // Entities of the lower partition are demoted as a whole
+        for (int i = 0; i < num_entities; i += 6)
+        {
+            scheme.change_partition(2, scheme.template get<client>(i));
+        }
+
+        np::fiber_pool<> pool;
+
+        THEN("each partition visits only its own entities")
+        {
+            REQUIRE(scheme.size(0) == 15);
+            REQUIRE(scheme.size(1) == 30);
+            REQUIRE(scheme.size(2) == 45);
+
+            pool.push([&pool, &scheme] {
+                for (uint8_t partition = 0; partition < 3; ++partition)
+                {
+                    np::counter counter;
+                    std::atomic<uint16_t> idx = 0;
+                    scheme_view_partition::parallel_chunked(counter, &pool, scheme, partition, [&idx, partition](auto client, auto npc)
+                        {
+                            REQUIRE(client->id() == npc->id());
+                            REQUIRE((client->id() % 6 == 0 ? 2 : client->id() % 3) == partition);
+                            ++idx;
+                        }, 8);
+
+                    counter.wait();
+                    REQUIRE(idx == scheme.size(partition));
+                }
+
+                np::counter counter;
+                std::atomic<uint16_t> idx = 0;
+                scheme_view_partition::continuous_by<npc>(counter, &pool, scheme, 1, [&idx](auto client, auto npc)
+                    {
+                        REQUIRE(client->id() % 3 == 1);
+                        ++idx;
+                    });
+
+                counter.wait();
+                REQUIRE(idx == 30);
+                pool.end();
+            });
+
+            pool.start();
+            pool.join();
+        }
+    }
+}
+
+SCENARIO("structural changes can be recorded from views and played back later")
+{
+    GIVEN("two partitioned schemes and a command buffer over the first one")
+    {
+        scheme_store<
+            partitioned_growable_storage<client, 128>,
+            partitioned_growable_storage<npc, 128>
+        > store;
+
+        scheme_store<
+            partitioned_growable_storage<client, 128>,
+            partitioned_growable_storage<npc, 128>
+        > other_store;
+
+        auto scheme = scheme_maker<client, npc>()(store);
+        auto other = scheme_maker<client, npc>()(other_store);
+        command_buffer buffer(scheme);
+
+        static constexpr int num_entities = 120;
+        for (int i = 0; i < num_entities; ++i)
+        {
+            scheme.create(i, scheme.template args<client>(true), scheme.template args<npc>(true));
+        }
+
+        np::fiber_pool<> pool;
+
+        WHEN("commands are recorded while iterating in parallel")
+        {
+            pool.push([&pool, &scheme, &other, &buffer] {
+                np::counter counter;
+                scheme_view::parallel_chunked(counter, &pool, scheme, [&scheme, &other, &buffer](auto obj, auto)
+                    {
+                        const auto id = obj->id();
+                        if (id % 4 == 0)
+                        {
+                            buffer.destroy(id);
+                            buffer.destroy(id);
+                        }
+                        else if (id % 4 == 1)
+                        {
+                            buffer.change_partition(false, id);
+                        }
+                        else if (id % 4 == 2)
+                        {
+                            buffer.move(other, id);
+                        }
+                        else
+                        {
+                            buffer.create(id + num_entities, scheme.template args<client>(false, 1), scheme.template args<npc>(false));
+                        }
+                    }, 8);
+
+                counter.wait();
+
+                // Nothing has changed yet
+                REQUIRE(scheme.size() == num_entities);
+                REQUIRE(scheme.size_until_partition() == num_entities);
+
+                buffer.playback();
+                pool.end();
+            });
+
+            pool.start();
+            pool.join();
+
+            THEN("they have all been applied")
+            {
+                REQUIRE(scheme.size() == num_entities / 2 + num_entities / 4);
+                REQUIRE(scheme.size_until_partition() == num_entities / 4);
+                REQUIRE(scheme.size_from_partition() == num_entities / 2);
+                REQUIRE(other.size() == num_entities / 4);
+
+                for (uint64_t id = 0; id < num_entities; ++id)
+                {
+                    auto entity = scheme.search(id);
+                    REQUIRE((entity.template get<client>() != nullptr) == (id % 2 == 1));
+                    REQUIRE((other.template get<client>().get(id) != nullptr) == (id % 4 == 2));
+
+                    if (id % 4 == 1)
+                    {
+                        REQUIRE(!scheme.template get<client>().raw_storage().partition(entity.template get<client>()));
+                        REQUIRE(!scheme.template get<npc>().raw_storage().partition(entity.template get<npc>()));
+                    }
+                    else if (id % 4 == 3)
+                    {
+                        REQUIRE(scheme.template get<client>(id + num_entities)->constructor_called);
+                        REQUIRE(scheme.template get<npc>(id + num_entities)->id() == id + num_entities);
+                    }
+                }
+            }
+        }
+
+        WHEN("an entity is moved more than once")
+        {
+            scheme_store<
+                partitioned_growable_storage<client, 128>,
+                partitioned_growable_storage<npc, 128>
+            > third_store;
+
+            auto third = scheme_maker<client, npc>()(third_store);
+
+            pool.push([&pool, &scheme, &other, &third, &buffer] {
+                buffer.move(other, 0);
+                buffer.move(third, 0);
+                buffer.move(third, 1);
+                buffer.move(other, 1);
+                buffer.move(other, 2);
+                buffer.move(other, 2);
+
+                buffer.playback();
+                pool.end();
+            });
+
+            pool.start();
+            pool.join();
+
+            THEN("only the last move recorded is applied")
+            {
+                REQUIRE(scheme.size() == num_entities - 3);
+                REQUIRE(other.size() == 2);
+                REQUIRE(third.size() == 1);
+
+                REQUIRE(third.template get<client>().get(0) != nullptr);
+                REQUIRE(other.template get<client>().get(1) != nullptr);
+                REQUIRE(other.template get<client>().get(2) != nullptr);
+                REQUIRE(other.template get<npc>().get(2) != nullptr);
+            }
+        }
+
+        WHEN("a buffer is destroyed with commands still recorded")
+        {
+            pool.push([&pool, &scheme] {
+                // Buffers in the same stack slot share an address
+                for (int i = 0; i < 2; ++i)
+                {
+                    command_buffer scoped(scheme);
+                    if (i == 0)
+                    {
+                        scoped.destroy(0);
+                    }
+                    else
+                    {
+                        scoped.destroy(1);
+                        scoped.playback();
+                    }
+                }
+
+                pool.end();
+            });
+
+            pool.start();
+            pool.join();
+
+            THEN("a later buffer does not play them back")
+            {
+                REQUIRE(scheme.size() == num_entities - 1);
+                REQUIRE(scheme.template get<client>(0) != nullptr);
+                REQUIRE(scheme.template get<client>(1) == nullptr);
+            }
+        }
+    }
+}
+
+SCENARIO("schemes sharing a storage only act upon their own entities")
+{
+    GIVEN("a partitioned scheme sharing its client storage with a client only scheme")
+    {
+        scheme_store<
+            partitioned_growable_storage<client, 128>,
+            partitioned_growable_storage<npc, 128>
+        > store;
+
+        scheme_store<
+            partitioned_growable_storage<client, 128>,
+            partitioned_growable_storage<npc, 128>
+        > other_store;
+
+        auto scheme = scheme_maker<client, npc>()(store);
+        auto other = scheme_maker<client, npc>()(other_store);
+        auto only = scheme_maker<client>()(store);
+
+        static constexpr int num_entities = 40;
+        for (int i = 0; i < num_entities; ++i)
+        {
+            scheme.create(i, scheme.template args<client>(true), scheme.template args<npc>(true));
+            only.create(i + num_entities, only.template args<client>(true));
+        }
+
+        bool incomplete = false;
+        auto check_complete = [&incomplete](client* client, npc* npc) { incomplete = incomplete || !client || !npc; };
+
+        // Sizes are those of the shared storage, thus only the entities themselves are checked
+        auto require_untouched = [&only]() {
+            for (uint64_t id = num_entities; id < num_entities * 2; ++id)
+            {
+                auto obj = only.template get<client>(id);
+                REQUIRE(obj->id() == id);
+                REQUIRE(only.template get<client>().raw_storage().partition(obj));
+            }
+        };
+
+        THEN("entities of the other scheme are not found")
+        {
+            REQUIRE(scheme.find(0));
+            REQUIRE(!scheme.find(num_entities));
+            REQUIRE(scheme.search(num_entities).template get<client>()->id() == num_entities);
+        }
+
+        WHEN("entities matching a predicate are moved")
+        {
+            auto moved = scheme.move_if(other, [&check_complete](client* client, npc* npc) {
+                check_complete(client, npc);
+                return client->id() % 2 == 0;
+            });
+
+            THEN("only entities of the scheme are moved")
+            {
+                REQUIRE(!incomplete);
+                REQUIRE(moved.size() == num_entities / 2);
+                REQUIRE(other.size() == num_entities / 2);
+                require_untouched();
+            }
+        }
+
+        WHEN("the scheme is partitioned by a predicate")
+        {
+            auto changed = scheme.partition([&check_complete](client* client, npc* npc) {
+                check_complete(client, npc);
+                return false;
+            });
+
+            THEN("only entities of the scheme change partition")
+            {
+                REQUIRE(!incomplete);
+                REQUIRE(changed.size() == num_entities);
+                require_untouched();
+            }
+        }
+
+        WHEN("commands targetting them are played back")
+        {
+            command_buffer buffer(scheme);
+            np::fiber_pool<> pool;
+
+            pool.push([&pool, &other, &buffer] {
+                for (uint64_t id = num_entities; id < num_entities * 2; ++id)
+                {
+                    buffer.destroy(id);
+                    buffer.move(other, id);
+                    buffer.change_partition(false, id);
+                }
+
+                buffer.playback();
+                pool.end();
+            });
+
+            pool.start();
+            pool.join();
+
+            THEN("they are skipped")
+            {
+                REQUIRE(other.size() == 0);
+                require_untouched();
+            }
+        }
+    }
+}
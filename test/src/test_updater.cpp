@@ -0,0 +1,943 @@
+#include <catch2/catch_all.hpp>
+
+#include <updater/core.hpp>
+#include <updater/lockfree_variant_tasks_manager.hpp>
+#include <updater/task_arena.hpp>
+#include <updater/tasks_manager.hpp>
+#include <updater/timer_wheel.hpp>
+#include <updater/variant_tasks_manager.hpp>
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <numeric>
+#include <span>
+#include <thread>
+#include <vector>
+
+
+struct queued_value
+{
+    int value;
+};
+
+struct grouped_a
+{
+    int value;
+};
+
+struct grouped_b
+{
+    int value;
+};
+
+struct grouped_c
+{
+    int value;
+};
+
+// Closure with a stricter alignment than the task header
+struct aligned_closure
+{
+    void operator()()
+    {
+        *address = reinterpret_cast<std::uintptr_t>(this);
+    }
+
+    alignas(64) std::uintptr_t* address;
+};
+
+// Phases as they start, along with the tick they were given
+struct tick_log
+{
+    using clock_t = std::chrono::steady_clock;
+
+    struct event
+    {
+        tick_phase phase;
+        uint64_t tick;
+        clock_t::time_point when;
+    };
+
+    void record(tick_phase phase, uint64_t tick)
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        events.push_back({ phase, tick, clock_t::now() });
+    }
+
+    std::vector<event> of(tick_phase phase) const
+    {
+        std::vector<event> result;
+        std::copy_if(events.begin(), events.end(), std::back_inserter(result), [phase](auto& event) { return event.phase == phase; });
+        return result;
+    }
+
+    std::mutex mutex;
+    std::vector<event> events;
+};
+
+struct keyed_value
+{
+    uint64_t key;
+    int submitter;
+    int sequence;
+};
+
+// Records keyed tasks as they run, tasks of a key must never overlap
+struct keyed_log
+{
+    static constexpr inline int submitters = 8;
+    static constexpr inline uint64_t keys = 16;
+    static constexpr inline int sequences = 50;
+
+    void run(uint64_t key, int submitter, int sequence)
+    {
+        if (in_flight[key].fetch_add(1) != 0)
+        {
+            overlapped = true;
+        }
+
+        runs[key].emplace_back(submitter, sequence);
+        in_flight[key].fetch_sub(1);
+    }
+
+    bool ordered_once() const
+    {
+        for (auto& key_runs : runs)
+        {
+            if (key_runs.size() != submitters * sequences)
+            {
+                return false;
+            }
+
+            // Each submitter's tasks for a key run in the order they were submitted
+            std::array<int, submitters> next{};
+            for (auto [submitter, sequence] : key_runs)
+            {
+                if (next[submitter]++ != sequence)
+                {
+                    return false;
+                }
+            }
+        }
+
+        return true;
+    }
+
+    std::array<std::atomic<int>, keys> in_flight{};
+    std::array<std::vector<std::pair<int, int>>, keys> runs;
+    std::atomic<bool> overlapped = false;
+};
+
+SCENARIO("Lockfree variant tasks are consumed in submission order", "[updater]")
+{
+    GIVEN("A lockfree manager and a fiber pool")
+    {
+        np::fiber_pool<> pool;
+        lockfree_variant_task_manager<int, queued_value> manager;
+
+        WHEN("a worker submits more values than fit in a block, twice")
+        {
+            std::vector<std::vector<int>> rounds;
+
+            pool.push([&pool, &manager, &rounds] {
+                for (int round = 0; round < 2; ++round)
+                {
+                    np::counter counter;
+                    pool.push([&manager] {
+                        // Rolls over two 256 entries blocks, the second round reuses the spare one
+                        for (int i = 0; i < 600; ++i)
+                        {
+                            if (i % 2)
+                            {
+                                manager.submit(i);
+                            }
+                            else
+                            {
+                                manager.submit(queued_value{ i });
+                            }
+                        }
+                    }, counter);
+                    counter.wait();
+
+                    auto& consumed = rounds.emplace_back();
+                    manager.execute([&consumed](auto& value) {
+                        if constexpr (std::is_same_v<std::decay_t<decltype(value)>, int>)
+                        {
+                            consumed.push_back(value);
+                        }
+                        else
+                        {
+                            consumed.push_back(value.value);
+                        }
+                    });
+                }
+
+                pool.end();
+            });
+
+            pool.start();
+            pool.join();
+
+            THEN("every value is consumed once and in order")
+            {
+                std::vector<int> expected(600);
+                std::iota(expected.begin(), expected.end(), 0);
+
+                REQUIRE(rounds.size() == 2);
+                REQUIRE(rounds[0] == expected);
+                REQUIRE(rounds[1] == expected);
+            }
+        }
+    }
+}
+
+SCENARIO("Unconsumed lockfree variant tasks are destroyed", "[updater]")
+{
+    GIVEN("Values holding a shared pointer")
+    {
+        auto shared = std::make_shared<int>(0);
+
+        WHEN("they are submitted but never executed")
+        {
+            {
+                np::fiber_pool<> pool;
+                lockfree_variant_task_manager<int, std::shared_ptr<int>> manager;
+
+                pool.push([&pool, &manager, shared] {
+                    np::counter counter;
+                    pool.push([&manager, shared] {
+                        for (int i = 0; i < 300; ++i)
+                        {
+                            manager.submit(shared);
+                        }
+                    }, counter);
+                    counter.wait();
+
+                    pool.end();
+                });
+
+                pool.start();
+                pool.join();
+
+                REQUIRE(shared.use_count() == 301);
+            }
+
+            THEN("the queues release them along with the pool")
+            {
+                REQUIRE(shared.use_count() == 1);
+            }
+        }
+    }
+}
+
+SCENARIO("Variant tasks can be executed grouped by alternative", "[updater]")
+{
+    GIVEN("A variant manager with interleaved submissions")
+    {
+        np::fiber_pool<> pool;
+        variant_task_manager<grouped_a, grouped_b, grouped_c> manager;
+
+        auto submit = [&manager] {
+            for (int i = 0; i < 100; ++i)
+            {
+                manager.submit(grouped_b{ i });
+                manager.submit(grouped_a{ i });
+            }
+        };
+
+        WHEN("executed grouped")
+        {
+            std::vector<std::pair<char, int>> visited;
+
+            pool.push([&pool, &manager, &submit, &visited] {
+                np::counter counter;
+                pool.push(submit, counter);
+                counter.wait();
+
+                manager.execute_grouped([&visited](auto& task) {
+                    using task_t = std::decay_t<decltype(task)>;
+                    visited.emplace_back(std::is_same_v<task_t, grouped_a> ? 'a' : (std::is_same_v<task_t, grouped_b> ? 'b' : 'c'), task.value);
+                });
+
+                pool.end();
+            });
+
+            pool.start();
+            pool.join();
+
+            THEN("all tasks of an alternative run together, in the order of the alternatives and of submission")
+            {
+                REQUIRE(visited.size() == 200);
+                for (int i = 0; i < 100; ++i)
+                {
+                    REQUIRE(visited[i] == std::make_pair('a', i));
+                    REQUIRE(visited[100 + i] == std::make_pair('b', i));
+                }
+            }
+        }
+
+        WHEN("executed batched")
+        {
+            std::vector<std::pair<char, std::vector<int>>> spans;
+
+            pool.push([&pool, &manager, &submit, &spans] {
+                np::counter counter;
+                pool.push(submit, counter);
+                pool.push(submit, counter);
+                counter.wait();
+
+                manager.execute_batched([&spans](auto batch) {
+                    using task_t = typename decltype(batch)::value_type;
+                    auto& [type, values] = spans.emplace_back(std::is_same_v<task_t, grouped_a> ? 'a' : (std::is_same_v<task_t, grouped_b> ? 'b' : 'c'), std::vector<int>());
+                    for (auto& task : batch)
+                    {
+                        values.push_back(task.value);
+                    }
+                });
+
+                pool.end();
+            });
+
+            pool.start();
+            pool.join();
+
+            THEN("there is one span per alternative with tasks, holding all of them")
+            {
+                REQUIRE(spans.size() == 2);
+                REQUIRE(spans[0].first == 'a');
+                REQUIRE(spans[0].second.size() == 200);
+                REQUIRE(spans[1].first == 'b');
+                REQUIRE(spans[1].second.size() == 200);
+
+                for (auto& [type, values] : spans)
+                {
+                    std::vector<int> counts(100, 0);
+                    for (auto value : values)
+                    {
+                        ++counts[value];
+                    }
+
+                    REQUIRE(std::all_of(counts.begin(), counts.end(), [](int count) { return count == 2; }));
+                }
+            }
+        }
+    }
+}
+
+SCENARIO("Keyed tasks submitted from several workers run once and in order per key", "[updater]")
+{
+    GIVEN("A fiber pool and a log of keyed tasks")
+    {
+        np::fiber_pool<> pool;
+        keyed_log log;
+
+        WHEN("tasks are scheduled with a key")
+        {
+            task_manager<> manager;
+
+            pool.push([&pool, &manager, &log] {
+                np::counter counter;
+                for (int submitter = 0; submitter < keyed_log::submitters; ++submitter)
+                {
+                    pool.push([&manager, &log, submitter] {
+                        for (int sequence = 0; sequence < keyed_log::sequences; ++sequence)
+                        {
+                            for (uint64_t key = 0; key < keyed_log::keys; ++key)
+                            {
+                                manager.schedule(key, [&log, key, submitter, sequence] {
+                                    log.run(key, submitter, sequence);
+                                });
+                            }
+                        }
+                    }, counter);
+                }
+                counter.wait();
+
+                manager.execute_parallel(&pool);
+                pool.end();
+            });
+
+            pool.start();
+            pool.join();
+
+            THEN("every task ran exactly once, in submission order and never alongside one of the same key")
+            {
+                REQUIRE(!log.overlapped);
+                REQUIRE(log.ordered_once());
+            }
+        }
+
+        WHEN("keyed and unkeyed tasks are interleaved")
+        {
+            task_manager<> manager;
+            std::vector<int> sequential;
+            std::vector<std::atomic<int>> parallel(100);
+
+            pool.push([&pool, &manager, &sequential, &parallel] {
+                for (int i = 0; i < 100; ++i)
+                {
+                    if (i % 3 == 0)
+                    {
+                        manager.schedule([&sequential, i] { sequential.push_back(i); });
+                    }
+                    else
+                    {
+                        manager.schedule(i % 5, [&sequential, i] { sequential.push_back(i); });
+                    }
+                }
+                manager.execute();
+
+                for (int i = 0; i < 100; ++i)
+                {
+                    if (i % 3 == 0)
+                    {
+                        manager.schedule([&parallel, i] { ++parallel[i]; });
+                    }
+                    else
+                    {
+                        manager.schedule(i % 5, [&parallel, i] { ++parallel[i]; });
+                    }
+                }
+                manager.execute_parallel(&pool);
+                pool.end();
+            });
+
+            pool.start();
+            pool.join();
+
+            THEN("executing sequentially keeps the submission order")
+            {
+                REQUIRE(sequential.size() == 100);
+                REQUIRE(std::is_sorted(sequential.begin(), sequential.end()));
+            }
+
+            THEN("executing in parallel runs every task once")
+            {
+                REQUIRE(std::all_of(parallel.begin(), parallel.end(), [](auto& count) { return count == 1; }));
+            }
+        }
+
+        WHEN("variant tasks are executed by key")
+        {
+            variant_task_manager<keyed_value, grouped_a> manager;
+
+            pool.push([&pool, &manager, &log] {
+                np::counter counter;
+                for (int submitter = 0; submitter < keyed_log::submitters; ++submitter)
+                {
+                    pool.push([&manager, submitter] {
+                        for (int sequence = 0; sequence < keyed_log::sequences; ++sequence)
+                        {
+                            for (uint64_t key = 0; key < keyed_log::keys; ++key)
+                            {
+                                manager.submit(keyed_value{ key, submitter, sequence });
+                            }
+                        }
+                    }, counter);
+                }
+                counter.wait();
+
+                manager.execute_parallel(&pool, [&log](auto& task) {
+                    if constexpr (std::is_same_v<std::decay_t<decltype(task)>, keyed_value>)
+                    {
+                        log.run(task.key, task.submitter, task.sequence);
+                    }
+                }, [](auto& task) -> uint64_t {
+                    if constexpr (std::is_same_v<std::decay_t<decltype(task)>, keyed_value>)
+                    {
+                        return task.key;
+                    }
+                    else
+                    {
+                        return 0;
+                    }
+                });
+
+                pool.end();
+            });
+
+            pool.start();
+            pool.join();
+
+            THEN("every task ran exactly once, in submission order and never alongside one of the same key")
+            {
+                REQUIRE(!log.overlapped);
+                REQUIRE(log.ordered_once());
+            }
+        }
+    }
+}
+
+SCENARIO("Task arenas pack closures of any size and alignment", "[updater]")
+{
+    GIVEN("A task arena")
+    {
+        task_arena<1024> arena;
+
+        WHEN("over aligned closures are pushed after small ones")
+        {
+            std::vector<std::uintptr_t> addresses(8);
+            int small = 0;
+            for (auto& address : addresses)
+            {
+                arena.push([&small] { ++small; });
+                arena.push(aligned_closure{ &address });
+            }
+
+            arena.execute();
+
+            THEN("every closure ran from a properly aligned address")
+            {
+                REQUIRE(small == 8);
+                REQUIRE(arena.empty());
+                for (auto address : addresses)
+                {
+                    REQUIRE(address != 0);
+                    REQUIRE(address % 64 == 0);
+                }
+            }
+        }
+
+        WHEN("a closure larger than a block is pushed")
+        {
+            std::array<int, 1024> big{};
+            big.back() = 42;
+
+            int result = 0;
+            arena.push([&result] { result += 1; });
+            arena.push([&result, big] { result += big.back(); });
+            arena.push([&result] { result += 100; });
+            arena.execute();
+
+            THEN("it gets a block of its own and runs in order")
+            {
+                REQUIRE(result == 143);
+            }
+        }
+
+        WHEN("the same closures are pushed again after executing")
+        {
+            // Enough tasks to span several blocks, recorded by the address returned on push
+            std::vector<std::uintptr_t> first;
+            std::vector<std::uintptr_t> second;
+            std::vector<int> ran(200);
+            for (auto* round : { &first, &second })
+            {
+                for (int i = 0; i < 200; ++i)
+                {
+                    round->push_back(reinterpret_cast<std::uintptr_t>(arena.push([&ran, i] { ++ran[i]; })));
+                }
+
+                arena.execute();
+            }
+
+            THEN("blocks are reused, tasks land at the same addresses")
+            {
+                REQUIRE(first == second);
+                REQUIRE(std::all_of(ran.begin(), ran.end(), [](int count) { return count == 2; }));
+            }
+        }
+    }
+
+    GIVEN("Tasks recording the order they ran in")
+    {
+        task_arena<1024> arena;
+        std::vector<int> order;
+        std::vector<task_arena<1024>::task*> tasks;
+        for (int i = 0; i < 6; ++i)
+        {
+            tasks.push_back(arena.push([&order, i] { order.push_back(i); }));
+        }
+
+        WHEN("the first, a middle and the last ones are unlinked")
+        {
+            arena.unlink_if([&tasks](auto task) { return task == tasks[0] || task == tasks[3] || task == tasks[5]; });
+
+            // Unlinked tasks are left to the caller, and must run before the arena is reset
+            (*tasks[5])();
+            (*tasks[0])();
+            (*tasks[3])();
+            arena.execute();
+
+            THEN("execute only runs the rest, in order")
+            {
+                REQUIRE(order == std::vector<int>{ 5, 0, 3, 1, 2, 4 });
+            }
+        }
+    }
+
+    GIVEN("Tasks holding a shared pointer")
+    {
+        auto shared = std::make_shared<int>(0);
+
+        WHEN("the arena is destroyed before running them")
+        {
+            {
+                task_arena<1024> arena;
+                for (int i = 0; i < 100; ++i)
+                {
+                    arena.push([shared] { ++*shared; });
+                }
+
+                REQUIRE(shared.use_count() == 101);
+            }
+
+            THEN("the closures are destroyed without running")
+            {
+                REQUIRE(shared.use_count() == 1);
+                REQUIRE(*shared == 0);
+            }
+        }
+    }
+}
+
+SCENARIO("Timed tasks accept move-only closures", "[updater]")
+{
+    GIVEN("A task manager and a fiber pool")
+    {
+        np::fiber_pool<> pool;
+        task_manager<> manager;
+
+        WHEN("a one-shot and a periodic task owning a unique pointer are scheduled, then ticked")
+        {
+            std::vector<int> once;
+            std::vector<int> periodic;
+
+            pool.push([&pool, &manager, &once, &periodic] {
+                manager.schedule_in(2, [&once, value = std::make_unique<int>(1)] { once.push_back(*value); });
+                auto ticket = manager.schedule_every(2, [&periodic, value = std::make_unique<int>(2)] { periodic.push_back(*value); });
+
+                for (int tick = 0; tick < 6; ++tick)
+                {
+                    manager.tick();
+                    manager.execute();
+                }
+
+                // Cancelled after being due, but before its task ran
+                manager.tick();
+                manager.tick();
+                manager.cancel(ticket);
+                manager.tick();
+                manager.execute();
+
+                pool.end();
+            });
+
+            pool.start();
+            pool.join();
+
+            THEN("the one-shot runs once, the periodic one every period and after its cancellation")
+            {
+                REQUIRE(once == std::vector<int>{ 1 });
+                REQUIRE(periodic == std::vector<int>{ 2, 2, 2, 2 });
+            }
+        }
+    }
+}
+
+SCENARIO("Timer wheels expire timers on the exact tick", "[updater]")
+{
+    GIVEN("A timer wheel and a fiber pool")
+    {
+        np::fiber_pool<> pool;
+        timer_wheel<uint32_t> wheel;
+        std::vector<std::pair<uint64_t, uint32_t>> expired;
+
+        auto tick = [&wheel, &expired](uint32_t ticks) {
+            for (uint32_t i = 0; i < ticks; ++i)
+            {
+                wheel.tick([&wheel, &expired](uint32_t value) {
+                    expired.emplace_back(wheel.now(), value);
+                });
+            }
+        };
+
+        WHEN("one-shot timers are scheduled on both sides of every level boundary")
+        {
+            const std::vector<uint32_t> delays = { 1, 255, 256, 257, 65535, 65536, 65537 };
+
+            pool.push([&pool, &wheel, &tick, &delays] {
+                for (auto delay : delays)
+                {
+                    wheel.schedule(delay, 0, delay);
+                }
+
+                tick(70000);
+                pool.end();
+            });
+
+            pool.start();
+            pool.join();
+
+            THEN("each one expires exactly once, after as many ticks as requested")
+            {
+                REQUIRE(expired.size() == delays.size());
+                for (std::size_t i = 0; i < delays.size(); ++i)
+                {
+                    REQUIRE(expired[i] == std::make_pair(uint64_t(delays[i]), delays[i]));
+                }
+            }
+        }
+
+        WHEN("a periodic timer is scheduled, then cancelled")
+        {
+            pool.push([&pool, &wheel, &tick] {
+                auto ticket = wheel.schedule(3, 3, 7);
+                tick(10);
+                wheel.cancel(ticket);
+                tick(10);
+                pool.end();
+            });
+
+            pool.start();
+            pool.join();
+
+            THEN("it is rearmed every period until cancelled")
+            {
+                REQUIRE(expired == std::vector<std::pair<uint64_t, uint32_t>>{ { 3, 7 }, { 6, 7 }, { 9, 7 } });
+            }
+        }
+
+        WHEN("a timer is cancelled from another worker in the same tick it was scheduled")
+        {
+            pool.push([&pool, &wheel, &tick] {
+                decltype(wheel)::ticket ticket;
+
+                np::counter counter;
+                pool.push([&wheel, &ticket] { ticket = wheel.schedule(1, 0, 1); }, counter);
+                counter.wait();
+
+                pool.push([&wheel, ticket] { wheel.cancel(ticket); }, counter);
+                wheel.schedule(2, 0, 2);
+                counter.wait();
+
+                tick(5);
+                pool.end();
+            });
+
+            pool.start();
+            pool.join();
+
+            THEN("it never expires")
+            {
+                REQUIRE(expired == std::vector<std::pair<uint64_t, uint32_t>>{ { 2, 2 } });
+            }
+        }
+
+        WHEN("a ticket is cancelled after its timer expired and its slot was reused")
+        {
+            pool.push([&pool, &wheel, &tick] {
+                auto stale = wheel.schedule(1, 0, 1);
+                tick(1);
+
+                // Same worker, thus the same node
+                wheel.schedule(2, 0, 2);
+                wheel.cancel(stale);
+                tick(5);
+                pool.end();
+            });
+
+            pool.start();
+            pool.join();
+
+            THEN("the new timer is left untouched")
+            {
+                REQUIRE(expired == std::vector<std::pair<uint64_t, uint32_t>>{ { 1, 1 }, { 3, 2 } });
+            }
+        }
+    }
+
+    GIVEN("Timers holding a shared pointer")
+    {
+        auto shared = std::make_shared<int>(0);
+
+        WHEN("the wheel is destroyed before they expire")
+        {
+            np::fiber_pool<> pool;
+
+            {
+                timer_wheel<std::shared_ptr<int>> wheel;
+                pool.push([&pool, &wheel, shared] {
+                    for (uint32_t i = 1; i <= 100; ++i)
+                    {
+                        wheel.schedule(i * 1000, 0, shared);
+                    }
+
+                    wheel.tick([](auto&&) {});
+                    pool.end();
+                });
+
+                pool.start();
+                pool.join();
+
+                REQUIRE(shared.use_count() == 101);
+            }
+
+            THEN("they are destroyed along with it, even outside the pool")
+            {
+                REQUIRE(shared.use_count() == 1);
+            }
+        }
+    }
+}
+
+SCENARIO("The core runs tick phases in order at a fixed timestep", "[updater]")
+{
+    using namespace std::chrono_literals;
+
+    GIVEN("A core recording every phase")
+    {
+        core<np::fiber_pool_traits> server(4);
+        tick_log log;
+
+        for (auto phase : { tick_phase::input, tick_phase::simulate, tick_phase::post_simulate, tick_phase::serialize })
+        {
+            server.on(phase, [&log, phase](np::counter&, auto*, uint64_t tick) {
+                log.record(phase, tick);
+            });
+        }
+
+        WHEN("it is stopped after some ticks")
+        {
+            std::atomic<bool> serialized = false;
+            server.on(tick_phase::post_simulate, [&server](np::counter&, auto*, uint64_t tick) {
+                if (tick == 19)
+                {
+                    server.stop();
+                }
+            });
+            server.on(tick_phase::serialize, [&serialized](np::counter& counter, auto* pool, uint64_t tick) {
+                if (tick == 19)
+                {
+                    pool->push([&serialized] {
+                        std::this_thread::sleep_for(5ms);
+                        serialized = true;
+                    }, counter);
+                }
+            });
+
+            server.run(2ms);
+            server.fiber_pool()->join();
+
+            THEN("every phase of every tick ran once and in order, up to the stopping tick")
+            {
+                REQUIRE(server.tick() == 20);
+                REQUIRE(log.events.size() == 20 * 4);
+                for (uint64_t tick = 0; tick < 20; ++tick)
+                {
+                    REQUIRE(log.events[tick * 4 + 0].phase == tick_phase::input);
+                    REQUIRE(log.events[tick * 4 + 1].phase == tick_phase::simulate);
+                    REQUIRE(log.events[tick * 4 + 2].phase == tick_phase::post_simulate);
+                    REQUIRE(log.events[tick * 4 + 3].phase == tick_phase::serialize);
+
+                    for (uint64_t phase = 0; phase < 4; ++phase)
+                    {
+                        REQUIRE(log.events[tick * 4 + phase].tick == tick);
+                    }
+                }
+            }
+
+            THEN("the last tick is serialized before returning")
+            {
+                REQUIRE(serialized);
+            }
+        }
+
+        WHEN("serializing a tick lasts until the next one gathers its input")
+        {
+            std::atomic<int> serializing = 0;
+            std::atomic<int> overlapped = 0;
+            std::atomic<int> raced = 0;
+            std::atomic<uint64_t> inputs = 0;
+
+            server.on(tick_phase::input, [&serializing, &overlapped, &inputs](np::counter&, auto*, uint64_t) {
+                if (serializing)
+                {
+                    ++overlapped;
+                }
+
+                ++inputs;
+            });
+            server.on(tick_phase::simulate, [&server, &serializing, &raced](np::counter&, auto*, uint64_t tick) {
+                if (serializing)
+                {
+                    ++raced;
+                }
+
+                if (tick == 9)
+                {
+                    server.stop();
+                }
+            });
+            server.on(tick_phase::serialize, [&serializing, &inputs](np::counter& counter, auto* pool, uint64_t tick) {
+                ++serializing;
+                pool->push([&serializing, &inputs, tick] {
+                    // Bounded, so that a core waiting for serialization before the next input fails instead of hanging
+                    const auto deadline = tick_log::clock_t::now() + 1s;
+                    while (tick < 9 && inputs < tick + 2 && tick_log::clock_t::now() < deadline)
+                    {
+                        np::this_fiber::yield();
+                    }
+
+                    --serializing;
+                }, counter);
+            });
+
+            server.run(2ms);
+            server.fiber_pool()->join();
+
+            THEN("the input of a tick overlaps the serialization of the previous one, but simulating waits for it")
+            {
+                REQUIRE(server.tick() == 10);
+                // Any serialization not run by the worker driving the ticks lasts until the next input
+                REQUIRE(overlapped > 0);
+                REQUIRE(raced == 0);
+                REQUIRE(serializing == 0);
+            }
+        }
+
+        WHEN("a tick takes many timesteps")
+        {
+            constexpr auto timestep = 10ms;
+            constexpr uint32_t max_catch_up = 3;
+
+            tick_log::clock_t::time_point stalled;
+            server.on(tick_phase::simulate, [&server, &stalled, timestep](np::counter&, auto*, uint64_t tick) {
+                if (tick == 5)
+                {
+                    std::this_thread::sleep_for(timestep * 10);
+                    stalled = tick_log::clock_t::now();
+                }
+
+                if (tick == 15)
+                {
+                    server.stop();
+                }
+            });
+
+            server.run(timestep, max_catch_up);
+            server.fiber_pool()->join();
+
+            THEN("a few ticks are run back to back to catch up, and the rest of the delay is dropped")
+            {
+                auto inputs = log.of(tick_phase::input);
+                REQUIRE(inputs.size() == 16);
+
+                // The stalled tick is part of the catch up, and once dropped the next tick is a timestep later
+                auto back_to_back = std::count_if(inputs.begin() + 6, inputs.end(), [stalled, timestep](auto& event) {
+                    return event.when - stalled < timestep;
+                });
+                REQUIRE(back_to_back <= max_catch_up);
+
+                // Without dropping the delay, about ten ticks would have run back to back. Ticks never run early,
+                //  thus this only bounds them from below
+                REQUIRE(inputs.back().when - stalled >= (15 - 5 - max_catch_up) * timestep);
+            }
+        }
+    }
+}